@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+namespace AllocationCounter
+{
+	std::size_t count();
+}
@@ -0,0 +1,140 @@
+#include "benchmark.hpp"
+
+#include "allocationCounter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+volatile unsigned char Benchmark::m_sink = 0;
+
+Benchmark::Benchmark(int repetitions) :
+	m_repetitions{repetitions}
+{ }
+
+void Benchmark::run(const std::string& name, int steps, const std::function<void()>& step)
+{
+	using Clock = std::chrono::steady_clock;
+
+	step();
+
+	double minNs = std::numeric_limits<double>::max();
+	std::size_t minAllocations = std::numeric_limits<std::size_t>::max();
+	for (int repetition = 0; repetition < m_repetitions; ++repetition)
+	{
+		std::size_t allocationsBefore = AllocationCounter::count();
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < steps; ++i)
+		{
+			step();
+		}
+		Clock::time_point end = Clock::now();
+		std::size_t allocations = AllocationCounter::count() - allocationsBefore;
+
+		minNs = std::min(minNs, std::chrono::duration<double, std::nano>(end - start).count());
+		minAllocations = std::min(minAllocations, allocations);
+	}
+
+	m_results.push_back({name, steps, minNs / steps, static_cast<double>(minAllocations) / steps});
+}
+
+const std::vector<Benchmark::Result>& Benchmark::getResults() const
+{
+	return m_results;
+}
+
+void Benchmark::print() const
+{
+	std::printf("%-32s %8s %14s %14s\n", "benchmark", "steps", "ns/step", "allocs/step");
+	for (const Result& result : m_results)
+	{
+		std::printf("%-32s %8d %14.1f %14.2f\n", result.name.c_str(), result.steps,
+			result.nsPerStep, result.allocationsPerStep);
+	}
+}
+
+bool Benchmark::save(const std::string& path) const
+{
+	std::ofstream file{path};
+	if (!file)
+	{
+		std::cerr << "Error writing baseline:\n" << path << '\n';
+		return false;
+	}
+
+	for (const Result& result : m_results)
+	{
+		file << result.name << ',' << result.steps << ',' << result.nsPerStep << ',' <<
+			result.allocationsPerStep << '\n';
+	}
+	return true;
+}
+
+bool Benchmark::compare(const std::string& baselinePath, double tolerance) const
+{
+	std::vector<Result> baseline = load(baselinePath);
+	if (baseline.empty())
+	{
+		std::cerr << "Error reading baseline:\n" << baselinePath << '\n';
+		return false;
+	}
+
+	bool passed = true;
+	for (const Result& result : m_results)
+	{
+		auto baselineResult = std::find_if(baseline.begin(), baseline.end(),
+			[&result] (const Result& baselineResult)
+			{
+				return baselineResult.name == result.name && baselineResult.steps == result.steps;
+			}
+		);
+		if (baselineResult == baseline.end())
+		{
+			continue;
+		}
+
+		if (result.nsPerStep > tolerance * baselineResult->nsPerStep)
+		{
+			std::printf("REGRESSION %s (%d steps): %.1f ns/step, baseline %.1f ns/step\n",
+				result.name.c_str(), result.steps, result.nsPerStep, baselineResult->nsPerStep);
+			passed = false;
+		}
+		if (result.allocationsPerStep > baselineResult->allocationsPerStep)
+		{
+			std::printf("REGRESSION %s (%d steps): %.2f allocs/step, baseline %.2f allocs/step\n",
+				result.name.c_str(), result.steps, result.allocationsPerStep,
+				baselineResult->allocationsPerStep);
+			passed = false;
+		}
+	}
+	return passed;
+}
+
+std::vector<Benchmark::Result> Benchmark::load(const std::string& path)
+{
+	std::vector<Result> results{};
+
+	std::ifstream file{path};
+	std::string line{};
+	while (std::getline(file, line))
+	{
+		std::istringstream stream{line};
+		Result result{};
+		if (!std::getline(stream, result.name, ','))
+		{
+			continue;
+		}
+		char separator{};
+		stream >> result.steps >> separator >> result.nsPerStep >> separator >>
+			result.allocationsPerStep;
+		if (stream)
+		{
+			results.push_back(result);
+		}
+	}
+	return results;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Benchmark
+{
+public:
+	struct Result
+	{
+		std::string name{};
+		int steps{};
+		double nsPerStep{};
+		double allocationsPerStep{};
+	};
+
+	Benchmark(int repetitions);
+
+	void run(const std::string& name, int steps, const std::function<void()>& step);
+	const std::vector<Result>& getResults() const;
+
+	void print() const;
+	bool save(const std::string& path) const;
+	bool compare(const std::string& baselinePath, double tolerance) const;
+
+	template <typename T>
+	static void consume(const T& value);
+
+private:
+	int m_repetitions{};
+	std::vector<Result> m_results{};
+
+	static volatile unsigned char m_sink;
+
+	static std::vector<Result> load(const std::string& path);
+};
+
+template <typename T>
+void Benchmark::consume(const T& value)
+{
+	m_sink = m_sink + *reinterpret_cast<const unsigned char*>(&value);
+}
@@ -0,0 +1,114 @@
+#include "benchmark.hpp"
+#include "scene.hpp"
+#include "shaderPrograms.hpp"
+#include "simulationBenchmarks.hpp"
+
+#include <glad/glad.h>
+#include <glfw/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+
+struct Options
+{
+	int repetitions = 5;
+	std::string objPath = "res/teapot.obj";
+	std::optional<std::string> baselinePath{};
+	std::optional<std::string> saveBaselinePath{};
+	std::optional<std::string> replayPath{};
+	double tolerance = 1.25;
+};
+
+static std::optional<Options> parseOptions(int argc, char** argv);
+
+int main(int argc, char** argv)
+{
+	std::optional<Options> options = parseOptions(argc, argv);
+	if (!options.has_value())
+	{
+		std::cerr << "Usage: " << argv[0] << " [--repetitions n] [--obj path] " <<
+			"[--baseline path] [--save-baseline path] [--tolerance ratio] [--replay path]\n";
+		return EXIT_FAILURE;
+	}
+
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(1, 1, "elastic-body-simulation-benchmark", nullptr,
+		nullptr);
+	glfwMakeContextCurrent(window);
+	gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+	ShaderPrograms::init();
+
+	bool passed = true;
+	{
+		static const glm::ivec2 viewportSize{1, 1};
+		Scene scene{viewportSize};
+		Benchmark benchmark{options->repetitions};
+		SimulationBenchmarks{scene.getSimulation()}.run(benchmark, options->objPath,
+			options->replayPath);
+		benchmark.print();
+
+		if (options->saveBaselinePath.has_value())
+		{
+			passed &= benchmark.save(*options->saveBaselinePath);
+		}
+		if (options->baselinePath.has_value())
+		{
+			passed &= benchmark.compare(*options->baselinePath, options->tolerance);
+		}
+	}
+
+	glfwTerminate();
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+std::optional<Options> parseOptions(int argc, char** argv)
+{
+	Options options{};
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		if (i + 1 >= argc)
+		{
+			return std::nullopt;
+		}
+		std::string value = argv[++i];
+
+		if (argument == "--repetitions")
+		{
+			options.repetitions = std::max(std::atoi(value.c_str()), 1);
+		}
+		else if (argument == "--obj")
+		{
+			options.objPath = value;
+		}
+		else if (argument == "--baseline")
+		{
+			options.baselinePath = value;
+		}
+		else if (argument == "--save-baseline")
+		{
+			options.saveBaselinePath = value;
+		}
+		else if (argument == "--replay")
+		{
+			options.replayPath = value;
+		}
+		else if (argument == "--tolerance")
+		{
+			options.tolerance = std::atof(value.c_str());
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	return options;
+}
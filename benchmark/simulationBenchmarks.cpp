@@ -0,0 +1,267 @@
+#include "simulationBenchmarks.hpp"
+
+#include "elasticCube.hpp"
+#include "meshLoader.hpp"
+#include "meshSimplifier.hpp"
+#include "objParser.hpp"
+#include "rungeKutta.hpp"
+#include "state.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+
+static constexpr std::array<int, 3> stepCounts{10, 100, 1000};
+static constexpr std::size_t lodCount = 4;
+
+SimulationBenchmarks::SimulationBenchmarks(Simulation& simulation) :
+	m_simulation{simulation}
+{ }
+
+void SimulationBenchmarks::run(Benchmark& benchmark, const std::string& objPath,
+	const std::optional<std::string>& replayPath)
+{
+	m_simulation.stop();
+
+	runRHS(benchmark);
+	runRK4(benchmark);
+	runStep(benchmark);
+	runXPBDStep(benchmark);
+	runTrajectory(benchmark);
+	runInternalSpringsForces(benchmark);
+	runCorotationalFEMForces(benchmark);
+	runStableDTEstimate(benchmark);
+	runCollisions(benchmark);
+	runCreateSprings(benchmark);
+	runStateToArray(benchmark);
+	runObjParser(benchmark, objPath);
+	// Replaying applies the recorded parameters, so it runs last to leave the others unaffected.
+	if (replayPath.has_value())
+	{
+		runReplay(benchmark, *replayPath);
+	}
+}
+
+void SimulationBenchmarks::runRHS(Benchmark& benchmark)
+{
+	State state = m_simulation.m_state;
+	benchmark.run("Simulation::getRHS", stepCounts[1],
+		[this, &state] ()
+		{
+			m_simulation.m_stepArena.reset();
+			Benchmark::consume(m_simulation.getRHS(state));
+		}
+	);
+}
+
+void SimulationBenchmarks::runRK4(Benchmark& benchmark)
+{
+	RungeKutta::State state = m_simulation.m_state.toArray();
+	benchmark.run("RungeKutta::RK4", stepCounts[1],
+		[this, &state] ()
+		{
+			m_simulation.m_stepArena.reset();
+			Benchmark::consume(RungeKutta::RK4(0, m_simulation.m_dT, state,
+				[this] (float, const RungeKutta::State& state)
+				{
+					return m_simulation.getRHS(state).toArray();
+				}
+			));
+		}
+	);
+}
+
+void SimulationBenchmarks::runStep(Benchmark& benchmark)
+{
+	State initialState = m_simulation.m_state;
+	for (int steps : stepCounts)
+	{
+		m_simulation.m_state = initialState;
+		m_simulation.disturb();
+		benchmark.run("Simulation step", steps,
+			[this] ()
+			{
+				m_simulation.m_stepArena.reset();
+				m_simulation.m_state = State{RungeKutta::RK4(0, m_simulation.m_dT,
+					m_simulation.m_state.toArray(),
+					[this] (float, const RungeKutta::State& state)
+					{
+						return m_simulation.getRHS(state).toArray();
+					}
+				)};
+				m_simulation.processCollisions();
+			}
+		);
+	}
+	m_simulation.m_state = initialState;
+}
+
+void SimulationBenchmarks::runXPBDStep(Benchmark& benchmark)
+{
+	State initialState = m_simulation.m_state;
+	for (int steps : stepCounts)
+	{
+		m_simulation.m_state = initialState;
+		m_simulation.disturb();
+		benchmark.run("XPBD step", steps,
+			[this] ()
+			{
+				m_simulation.m_stepArena.reset();
+				m_simulation.stepXPBD();
+				m_simulation.processCollisions();
+			}
+		);
+	}
+	m_simulation.m_state = initialState;
+}
+
+void SimulationBenchmarks::runTrajectory(Benchmark& benchmark)
+{
+	// Moving the control cube also moves the anchor targets, the checkpoint restores both.
+	Simulation::Checkpoint initialCheckpoint{};
+	m_simulation.saveCheckpoint(initialCheckpoint);
+	m_simulation.setControlCubeTrajectory(Simulation::ControlCubeTrajectory::shake);
+	Simulation::Checkpoint trajectoryCheckpoint{};
+	m_simulation.saveCheckpoint(trajectoryCheckpoint);
+	for (int steps : stepCounts)
+	{
+		m_simulation.loadCheckpoint(trajectoryCheckpoint);
+		benchmark.run("Simulation step (trajectory)", steps,
+			[this] ()
+			{
+				m_simulation.step(0);
+			}
+		);
+	}
+	m_simulation.loadCheckpoint(initialCheckpoint);
+}
+
+void SimulationBenchmarks::runReplay(Benchmark& benchmark, const std::string& replayPath)
+{
+	if (!m_simulation.loadRecording(replayPath))
+	{
+		std::cerr << "Skipping replay, file cannot be loaded:\n" << replayPath << '\n';
+		return;
+	}
+
+	// Every repetition replays the whole recording from its initial state.
+	State initialState = m_simulation.m_state;
+	int steps = static_cast<int>(m_simulation.getRecording()->getStepCount());
+	benchmark.run("Simulation replay", std::max(steps, 1),
+		[this] ()
+		{
+			if (!m_simulation.isReplaying())
+			{
+				m_simulation.startReplay();
+			}
+			m_simulation.step(0);
+		}
+	);
+	m_simulation.stopReplay();
+	m_simulation.stop();
+	m_simulation.m_state = initialState;
+}
+
+void SimulationBenchmarks::runInternalSpringsForces(Benchmark& benchmark)
+{
+	State state = m_simulation.m_state;
+	benchmark.run("getInternalSpringsForces", stepCounts[1],
+		[this, &state] ()
+		{
+			m_simulation.m_stepArena.reset();
+			Benchmark::consume(m_simulation.getInternalSpringsForces(state)[0]);
+		}
+	);
+}
+
+void SimulationBenchmarks::runCorotationalFEMForces(Benchmark& benchmark)
+{
+	State state = m_simulation.m_state;
+	benchmark.run("CorotationalFEM::getForces", stepCounts[1],
+		[this, &state] ()
+		{
+			m_simulation.m_stepArena.reset();
+			Benchmark::consume(m_simulation.m_corotationalFEM.getForces(state,
+				m_simulation.m_youngModulus, m_simulation.m_poissonRatio,
+				&m_simulation.m_stepArena)[0]);
+		}
+	);
+}
+
+void SimulationBenchmarks::runStableDTEstimate(Benchmark& benchmark)
+{
+	benchmark.run("Simulation::estimateStableDT", stepCounts[1],
+		[this] ()
+		{
+			Benchmark::consume(m_simulation.estimateStableDT());
+		}
+	);
+}
+
+void SimulationBenchmarks::runCollisions(Benchmark& benchmark)
+{
+	State initialState = m_simulation.m_state;
+	benchmark.run("processCollisions", stepCounts[1],
+		[this] ()
+		{
+			m_simulation.processCollisions();
+		}
+	);
+	m_simulation.m_state = initialState;
+}
+
+void SimulationBenchmarks::runCreateSprings(Benchmark& benchmark)
+{
+	benchmark.run("ElasticCube::createSprings", stepCounts[1],
+		[] ()
+		{
+			Benchmark::consume(ElasticCube::createSprings()[0]);
+		}
+	);
+}
+
+void SimulationBenchmarks::runStateToArray(Benchmark& benchmark)
+{
+	State state = m_simulation.m_state;
+	benchmark.run("State::toArray", stepCounts[2],
+		[&state] ()
+		{
+			Benchmark::consume(state.toArray());
+		}
+	);
+}
+
+void SimulationBenchmarks::runObjParser(Benchmark& benchmark, const std::string& objPath)
+{
+	std::optional<IndexedMesh> mesh = ObjParser::parse(objPath);
+	if (!mesh)
+	{
+		std::cerr << "Skipping ObjParser::parse, file cannot be parsed:\n" << objPath << '\n';
+		return;
+	}
+
+	benchmark.run("ObjParser::parse", 1,
+		[&objPath] ()
+		{
+			Benchmark::consume(ObjParser::parse(objPath)->indices.size());
+		}
+	);
+
+	benchmark.run("MeshSimplifier::simplify", 1,
+		[&mesh] ()
+		{
+			Benchmark::consume(
+				MeshSimplifier::simplify(*mesh, mesh->indices.size() / 12).indices.size());
+		}
+	);
+
+	MeshLoader::loadLODs(objPath, lodCount);
+	benchmark.run("MeshLoader::loadLODs (cached)", 1,
+		[&objPath] ()
+		{
+			Benchmark::consume(MeshLoader::loadLODs(objPath, lodCount).size());
+		}
+	);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "benchmark.hpp"
+#include "simulation.hpp"
+
+#include <optional>
+#include <string>
+
+class SimulationBenchmarks
+{
+public:
+	SimulationBenchmarks(Simulation& simulation);
+
+	void run(Benchmark& benchmark, const std::string& objPath,
+		const std::optional<std::string>& replayPath);
+
+private:
+	Simulation& m_simulation;
+
+	void runRHS(Benchmark& benchmark);
+	void runRK4(Benchmark& benchmark);
+	void runStep(Benchmark& benchmark);
+	void runXPBDStep(Benchmark& benchmark);
+	void runTrajectory(Benchmark& benchmark);
+	void runReplay(Benchmark& benchmark, const std::string& replayPath);
+	void runInternalSpringsForces(Benchmark& benchmark);
+	void runCorotationalFEMForces(Benchmark& benchmark);
+	void runStableDTEstimate(Benchmark& benchmark);
+	void runCollisions(Benchmark& benchmark);
+	void runCreateSprings(Benchmark& benchmark);
+	void runStateToArray(Benchmark& benchmark);
+	void runObjParser(Benchmark& benchmark, const std::string& objPath);
+};
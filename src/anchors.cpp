@@ -0,0 +1,106 @@
+#include "anchors.hpp"
+
+#include <algorithm>
+
+std::size_t Anchors::add(std::span<const std::size_t> points, std::span<const glm::vec3> targets,
+	float stiffness, float damping)
+{
+	std::size_t first = m_points.size();
+	m_points.insert(m_points.end(), points.begin(), points.end());
+	m_targets.insert(m_targets.end(), targets.begin(), targets.end());
+	m_targetVelocities.resize(m_points.size());
+	m_stiffnesses.resize(m_points.size(), stiffness);
+	m_dampings.resize(m_points.size(), damping);
+	return first;
+}
+
+std::size_t Anchors::size() const
+{
+	return m_points.size();
+}
+
+std::span<const std::size_t> Anchors::getPoints() const
+{
+	return m_points;
+}
+
+std::span<const glm::vec3> Anchors::getTargets() const
+{
+	return m_targets;
+}
+
+std::span<const float> Anchors::getStiffnesses() const
+{
+	return m_stiffnesses;
+}
+
+std::span<const float> Anchors::getDampings() const
+{
+	return m_dampings;
+}
+
+void Anchors::setTargets(std::size_t first, std::span<const glm::vec3> targets, float dT)
+{
+	for (std::size_t i = 0; i < targets.size(); ++i)
+	{
+		m_targetVelocities[first + i] = (targets[i] - m_targets[first + i]) / dT;
+		m_targets[first + i] = targets[i];
+	}
+}
+
+void Anchors::resetTargets(std::size_t first, std::span<const glm::vec3> targets)
+{
+	std::copy(targets.begin(), targets.end(), m_targets.begin() + first);
+	std::fill_n(m_targetVelocities.begin() + first, targets.size(), glm::vec3{});
+}
+
+void Anchors::setStiffness(std::size_t first, std::size_t count, float stiffness)
+{
+	std::fill_n(m_stiffnesses.begin() + first, count, stiffness);
+}
+
+void Anchors::setDamping(std::size_t first, std::size_t count, float damping)
+{
+	std::fill_n(m_dampings.begin() + first, count, damping);
+}
+
+float Anchors::addForces(const State& state, std::span<glm::vec3> forces) const
+{
+	float energy = 0;
+	for (std::size_t i = 0; i < m_points.size(); ++i)
+	{
+		std::size_t point = m_points[i];
+		glm::vec3 extension = m_targets[i] - state.poss[point];
+		glm::vec3 relativeVelocity = state.velocities[point] - m_targetVelocities[i];
+		forces[point] += m_stiffnesses[i] * extension - m_dampings[i] * relativeVelocity;
+		energy += 0.5f * m_stiffnesses[i] * glm::dot(extension, extension);
+	}
+	return energy;
+}
+
+void Anchors::addStiffnessProduct(std::span<const glm::vec3> direction,
+	std::span<glm::vec3> product) const
+{
+	for (std::size_t i = 0; i < m_points.size(); ++i)
+	{
+		product[m_points[i]] += m_stiffnesses[i] * direction[m_points[i]];
+	}
+}
+
+float Anchors::getMaxDamping() const
+{
+	if (m_dampings.empty())
+	{
+		return 0;
+	}
+	return *std::max_element(m_dampings.begin(), m_dampings.end());
+}
+
+void Anchors::addDampingForces(const State& state, std::span<glm::vec3> forces) const
+{
+	for (std::size_t i = 0; i < m_points.size(); ++i)
+	{
+		std::size_t point = m_points[i];
+		forces[point] -= m_dampings[i] * (state.velocities[point] - m_targetVelocities[i]);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "state.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Lattice points attached to kinematic targets by zero-length springs with dashpots. Anchors are
+// stored as parallel arrays and added in consecutive ranges, one per handle driving them, so a
+// handle updates its targets with a single contiguous write and every pass is one linear sweep.
+class Anchors
+{
+public:
+	// Returns the index of the first added anchor, which identifies the range to its handle.
+	std::size_t add(std::span<const std::size_t> points, std::span<const glm::vec3> targets,
+		float stiffness, float damping);
+
+	std::size_t size() const;
+	std::span<const std::size_t> getPoints() const;
+	std::span<const glm::vec3> getTargets() const;
+	std::span<const float> getStiffnesses() const;
+	std::span<const float> getDampings() const;
+
+	// Set before every step. The dashpots damp the velocity of the points relative to the targets,
+	// which move by their displacement since the previous step over dT.
+	void setTargets(std::size_t first, std::span<const glm::vec3> targets, float dT);
+	// Moves the targets without giving them a velocity.
+	void resetTargets(std::size_t first, std::span<const glm::vec3> targets);
+	void setStiffness(std::size_t first, std::size_t count, float stiffness);
+	void setDamping(std::size_t first, std::size_t count, float damping);
+
+	// Returns the energy stored in the springs.
+	float addForces(const State& state, std::span<glm::vec3> forces) const;
+	// Only the dashpots, for solvers that enforce the springs as constraints.
+	void addDampingForces(const State& state, std::span<glm::vec3> forces) const;
+	// Adds the product of the springs' stiffness matrix and the direction.
+	void addStiffnessProduct(std::span<const glm::vec3> direction,
+		std::span<glm::vec3> product) const;
+	float getMaxDamping() const;
+
+private:
+	std::vector<std::size_t> m_points{};
+	std::vector<glm::vec3> m_targets{};
+	std::vector<glm::vec3> m_targetVelocities{};
+	std::vector<float> m_stiffnesses{};
+	std::vector<float> m_dampings{};
+};
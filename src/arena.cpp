@@ -0,0 +1,95 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+Arena::Arena(std::size_t capacity) :
+	m_block{std::make_unique_for_overwrite<std::byte[]>(capacity)},
+	m_capacity{capacity}
+{ }
+
+Arena::~Arena()
+{
+	releaseOverflows();
+}
+
+void Arena::reset()
+{
+	std::size_t usedBytes = getUsedBytes();
+	releaseOverflows();
+	if (usedBytes > m_capacity)
+	{
+		m_capacity = std::max(2 * m_capacity, usedBytes);
+		m_block = std::make_unique_for_overwrite<std::byte[]>(m_capacity);
+	}
+	m_offset = 0;
+	m_allocationCount = 0;
+}
+
+std::size_t Arena::getAllocationCount() const
+{
+	return m_allocationCount;
+}
+
+std::size_t Arena::getUsedBytes() const
+{
+	return m_offset + m_overflowBytes;
+}
+
+std::size_t Arena::getCapacity() const
+{
+	return m_capacity;
+}
+
+std::size_t Arena::getPeakBytes() const
+{
+	return m_peakBytes;
+}
+
+std::size_t Arena::getOverflowCount() const
+{
+	return m_overflowCount;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+	++m_allocationCount;
+
+	std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_block.get());
+	std::size_t begin = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+	void* ptr = nullptr;
+	if (begin + bytes <= m_capacity)
+	{
+		ptr = m_block.get() + begin;
+		m_offset = begin + bytes;
+	}
+	else
+	{
+		ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		m_overflows.push_back({ptr, bytes, alignment});
+		m_overflowBytes += bytes;
+		++m_overflowCount;
+	}
+
+	m_peakBytes = std::max(m_peakBytes, getUsedBytes());
+	return ptr;
+}
+
+void Arena::do_deallocate(void*, std::size_t, std::size_t)
+{ }
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+void Arena::releaseOverflows()
+{
+	for (const Overflow& overflow : m_overflows)
+	{
+		std::pmr::new_delete_resource()->deallocate(overflow.ptr, overflow.bytes,
+			overflow.alignment);
+	}
+	m_overflows.clear();
+	m_overflowBytes = 0;
+}
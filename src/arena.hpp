@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Linear allocator for scratch data that lives for a single simulation step or frame. Allocations
+// bump an offset through one block and deallocations are ignored; reset() frees everything at
+// once. Whatever does not fit in the block is taken from the heap, and the block grows on the next
+// reset, so a workload that repeats every cycle stops touching the heap after its first cycle.
+// Not thread-safe: allocate only from the thread that resets the arena.
+class Arena : public std::pmr::memory_resource
+{
+public:
+	Arena(std::size_t capacity);
+	Arena(const Arena&) = delete;
+	Arena(Arena&&) = delete;
+	~Arena() override;
+
+	Arena& operator=(const Arena&) = delete;
+	Arena& operator=(Arena&&) = delete;
+
+	void reset();
+
+	// Counters of the current cycle, i.e. since the last reset.
+	std::size_t getAllocationCount() const;
+	std::size_t getUsedBytes() const;
+
+	std::size_t getCapacity() const;
+	std::size_t getPeakBytes() const;
+	// Allocations that did not fit in the block and went to the heap, since the arena was created.
+	std::size_t getOverflowCount() const;
+
+private:
+	struct Overflow
+	{
+		void* ptr{};
+		std::size_t bytes{};
+		std::size_t alignment{};
+	};
+
+	std::unique_ptr<std::byte[]> m_block{};
+	std::size_t m_capacity{};
+	std::size_t m_offset{};
+	std::vector<Overflow> m_overflows{};
+	std::size_t m_overflowBytes{};
+
+	std::size_t m_allocationCount{};
+	std::size_t m_peakBytes{};
+	std::size_t m_overflowCount{};
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	void releaseOverflows();
+};
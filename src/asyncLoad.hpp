@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <optional>
+#include <utility>
+
+// Runs a loading function on a worker thread. The result is polled once per frame on the GL
+// thread, which then performs the upload.
+template <typename T>
+class AsyncLoad
+{
+public:
+	AsyncLoad() = default;
+
+	template <typename Load>
+	AsyncLoad(Load load) :
+		m_future{std::async(std::launch::async, std::move(load))}
+	{ }
+
+	bool isPending() const
+	{
+		return m_future.valid();
+	}
+
+	std::optional<T> poll()
+	{
+		if (!m_future.valid() ||
+			m_future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+		{
+			return std::nullopt;
+		}
+		return m_future.get();
+	}
+
+private:
+	std::future<T> m_future{};
+};
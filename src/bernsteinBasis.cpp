@@ -0,0 +1,22 @@
+#include "bernsteinBasis.hpp"
+
+BernsteinBasis::BernsteinBasis(const glm::vec3& parameters) :
+	u{cubic(parameters.x)},
+	v{cubic(parameters.y)},
+	w{cubic(parameters.z)},
+	derivU{cubicDeriv(parameters.x)},
+	derivV{cubicDeriv(parameters.y)},
+	derivW{cubicDeriv(parameters.z)}
+{ }
+
+glm::vec4 BernsteinBasis::cubic(float t)
+{
+	float s = 1 - t;
+	return {s * s * s, 3 * t * s * s, 3 * t * t * s, t * t * t};
+}
+
+glm::vec4 BernsteinBasis::cubicDeriv(float t)
+{
+	float s = 1 - t;
+	return {-3 * s * s, 3 * s * s - 6 * t * s, 6 * t * s - 3 * t * t, 3 * t * t};
+}
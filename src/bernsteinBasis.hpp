@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct BernsteinBasis
+{
+	glm::vec4 u{};
+	glm::vec4 v{};
+	glm::vec4 w{};
+	glm::vec4 derivU{};
+	glm::vec4 derivV{};
+	glm::vec4 derivW{};
+
+	BernsteinBasis() = default;
+	BernsteinBasis(const glm::vec3& parameters);
+
+	static glm::vec4 cubic(float t);
+	static glm::vec4 cubicDeriv(float t);
+};
@@ -110,14 +110,24 @@ glm::vec3 Camera::getPos() const
 
 void Camera::updateShaders() const
 {
-	ShaderPrograms::bezier->use();
-	ShaderPrograms::bezier->setUniform("projectionViewMatrix", getMatrix());
-	ShaderPrograms::bezier->setUniform("cameraPos", getPos());
+	if (ShaderPrograms::bezier->isReady())
+	{
+		ShaderPrograms::bezier->use();
+		ShaderPrograms::bezier->setUniform("projectionViewMatrix", getMatrix());
+		ShaderPrograms::bezier->setUniform("cameraPos", getPos());
+		ShaderPrograms::bezier->setUniform("viewportSize", m_viewportSize);
+	}
 
-	ShaderPrograms::teapot->use();
-	ShaderPrograms::teapot->setUniform("projectionViewMatrix", getMatrix());
-	ShaderPrograms::teapot->setUniform("cameraPos", getPos());
+	if (ShaderPrograms::teapot->isReady())
+	{
+		ShaderPrograms::teapot->use();
+		ShaderPrograms::teapot->setUniform("projectionViewMatrix", getMatrix());
+		ShaderPrograms::teapot->setUniform("cameraPos", getPos());
+	}
 
-	ShaderPrograms::lines->use();
-	ShaderPrograms::lines->setUniform("projectionViewMatrix", getMatrix());
+	if (ShaderPrograms::lines->isReady())
+	{
+		ShaderPrograms::lines->use();
+		ShaderPrograms::lines->setUniform("projectionViewMatrix", getMatrix());
+	}
 }
@@ -10,6 +10,7 @@ public:
 
 	void use() const;
 	glm::mat4 getMatrix() const;
+	glm::vec3 getPos() const;
 	void updateViewportSize();
 
 	void moveX(float x);
@@ -37,6 +38,5 @@ private:
 	float m_pitchRad = 0;
 	float m_yawRad = 0;
 
-	glm::vec3 getPos() const;
 	void updateShaders() const;
 };
@@ -7,17 +7,16 @@
 ControlCube::ControlCube(const glm::vec3& size)
 {
 	m_vertices = createVertices(size);
+	updateCorners();
 }
 
-std::vector<glm::vec3> ControlCube::getCorners() const
+std::span<const glm::vec3> ControlCube::getCorners() const
 {
-	std::vector<glm::vec3> corners{};
-	for (const glm::vec3& vertex : m_vertices)
+	if (m_cornersGeneration != getGeneration())
 	{
-		glm::vec4 affineVertex{vertex, 1};
-		corners.push_back({getMatrix() * affineVertex});
+		updateCorners();
 	}
-	return corners;
+	return m_corners;
 }
 
 std::vector<glm::vec3> ControlCube::createVertices(const glm::vec3& size)
@@ -39,6 +38,16 @@ std::vector<glm::vec3> ControlCube::createVertices(const glm::vec3& size)
 	return vertices;
 }
 
+void ControlCube::updateCorners() const
+{
+	glm::mat4 matrix = getMatrix();
+	for (std::size_t i = 0; i < m_vertices.size(); ++i)
+	{
+		m_corners[i] = glm::vec3{matrix * glm::vec4{m_vertices[i], 1}};
+	}
+	m_cornersGeneration = getGeneration();
+}
+
 std::size_t ControlCube::index(std::size_t xi, std::size_t yi, std::size_t zi)
 {
 	return 4 * zi + 2 * yi + xi;
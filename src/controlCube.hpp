@@ -5,7 +5,10 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 class ControlCube : public Frame
@@ -14,11 +17,16 @@ public:
 	ControlCube(const glm::vec3& size);
 	virtual ~ControlCube() = default;
 
-	std::vector<glm::vec3> getCorners() const;
+	// Cached, recomputed only after the pose changed.
+	std::span<const glm::vec3> getCorners() const;
 	static std::vector<glm::vec3> createVertices(const glm::vec3& size);
 
 private:
 	std::vector<glm::vec3> m_vertices{};
+	mutable std::array<glm::vec3, 8> m_corners{};
+	mutable std::uint64_t m_cornersGeneration{};
+
+	void updateCorners() const;
 
 	static std::size_t index(std::size_t xi, std::size_t yi, std::size_t zi);
 };
@@ -0,0 +1,186 @@
+#include "corotationalFEM.hpp"
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+CorotationalFEM::CorotationalFEM(const LatticeTopology& topology) :
+	m_topology{topology},
+	m_rotations(topology.getTetrahedra().size())
+{
+	const std::vector<glm::vec3>& restPoss = m_topology.getRestPoss();
+	for (const LatticeTopology::Tetrahedron& tetrahedron : m_topology.getTetrahedra())
+	{
+		glm::mat3 restShape
+		{
+			restPoss[tetrahedron[1]] - restPoss[tetrahedron[0]],
+			restPoss[tetrahedron[2]] - restPoss[tetrahedron[0]],
+			restPoss[tetrahedron[3]] - restPoss[tetrahedron[0]]
+		};
+		m_restShapeInverses.push_back(glm::inverse(restShape));
+		m_restVolumes.push_back(std::abs(glm::determinant(restShape)) / 6.0f);
+	}
+}
+
+std::pmr::vector<glm::vec3> CorotationalFEM::getForces(const State& state, float youngModulus,
+	float poissonRatio, std::pmr::memory_resource* resource, float* energy) const
+{
+	LameParameters parameters = lameParameters(youngModulus, poissonRatio);
+	float mu = parameters.mu;
+	float lambda = parameters.lambda;
+
+	const std::vector<LatticeTopology::Tetrahedron>& tetrahedra = m_topology.getTetrahedra();
+	std::pmr::vector<glm::vec3> slotForces(4 * tetrahedra.size(), resource);
+	auto evaluateElements =
+		[this, &tetrahedra, &state, &slotForces, mu, lambda] (std::size_t begin, std::size_t end)
+		{
+			float strainEnergy = 0;
+			for (std::size_t element = begin; element < end; ++element)
+			{
+				const LatticeTopology::Tetrahedron& tetrahedron = tetrahedra[element];
+				glm::mat3 shape
+				{
+					state.poss[tetrahedron[1]] - state.poss[tetrahedron[0]],
+					state.poss[tetrahedron[2]] - state.poss[tetrahedron[0]],
+					state.poss[tetrahedron[3]] - state.poss[tetrahedron[0]]
+				};
+				const glm::mat3& restShapeInverse = m_restShapeInverses[element];
+				glm::mat3 deformationGradient = shape * restShapeInverse;
+
+				extractRotation(deformationGradient, m_rotations[element]);
+				glm::mat3 rotation = glm::mat3_cast(m_rotations[element]);
+
+				// First Piola-Kirchhoff stress of the corotated linear material.
+				glm::mat3 rotatedGradient = glm::transpose(rotation) * deformationGradient;
+				float volumetricStrain = rotatedGradient[0][0] + rotatedGradient[1][1] +
+					rotatedGradient[2][2] - 3;
+				glm::mat3 stress = 2 * mu * (deformationGradient - rotation) +
+					lambda * volumetricStrain * rotation;
+
+				glm::mat3 cornerForces = -m_restVolumes[element] * stress *
+					glm::transpose(restShapeInverse);
+				slotForces[4 * element] = -(cornerForces[0] + cornerForces[1] + cornerForces[2]);
+				slotForces[4 * element + 1] = cornerForces[0];
+				slotForces[4 * element + 2] = cornerForces[1];
+				slotForces[4 * element + 3] = cornerForces[2];
+
+				glm::mat3 rotatedStrain = deformationGradient - rotation;
+				float deviatoricEnergy = glm::dot(rotatedStrain[0], rotatedStrain[0]) +
+					glm::dot(rotatedStrain[1], rotatedStrain[1]) +
+					glm::dot(rotatedStrain[2], rotatedStrain[2]);
+				strainEnergy += m_restVolumes[element] * (mu * deviatoricEnergy +
+					0.5f * lambda * volumetricStrain * volumetricStrain);
+			}
+			return strainEnergy;
+		};
+
+	if (energy != nullptr)
+	{
+		*energy = Parallel::sumRanges(tetrahedra.size(), elementGrainSize, evaluateElements);
+	}
+	else
+	{
+		Parallel::forRange(tetrahedra.size(), elementGrainSize, evaluateElements);
+	}
+
+	return m_topology.getTetrahedronGatherList().gather(slotForces, resource);
+}
+
+std::pmr::vector<glm::vec3> CorotationalFEM::getStiffnessProduct(
+	std::span<const glm::vec3> direction, float youngModulus, float poissonRatio,
+	std::pmr::memory_resource* resource) const
+{
+	LameParameters parameters = lameParameters(youngModulus, poissonRatio);
+	float mu = parameters.mu;
+	float lambda = parameters.lambda;
+
+	const std::vector<LatticeTopology::Tetrahedron>& tetrahedra = m_topology.getTetrahedra();
+	std::pmr::vector<glm::vec3> slotProducts(4 * tetrahedra.size(), resource);
+	Parallel::forRange(tetrahedra.size(), elementGrainSize,
+		[this, &tetrahedra, direction, &slotProducts, mu, lambda]
+		(std::size_t begin, std::size_t end)
+		{
+			for (std::size_t element = begin; element < end; ++element)
+			{
+				// Differential of the forces with the rotation held fixed.
+				const LatticeTopology::Tetrahedron& tetrahedron = tetrahedra[element];
+				glm::mat3 shapeDifferential
+				{
+					direction[tetrahedron[1]] - direction[tetrahedron[0]],
+					direction[tetrahedron[2]] - direction[tetrahedron[0]],
+					direction[tetrahedron[3]] - direction[tetrahedron[0]]
+				};
+				const glm::mat3& restShapeInverse = m_restShapeInverses[element];
+				glm::mat3 gradientDifferential = shapeDifferential * restShapeInverse;
+				glm::mat3 rotation = glm::mat3_cast(m_rotations[element]);
+
+				glm::mat3 rotatedDifferential = glm::transpose(rotation) * gradientDifferential;
+				float volumetricDifferential = rotatedDifferential[0][0] +
+					rotatedDifferential[1][1] + rotatedDifferential[2][2];
+				glm::mat3 stressDifferential = 2 * mu * gradientDifferential +
+					lambda * volumetricDifferential * rotation;
+
+				glm::mat3 cornerProducts = m_restVolumes[element] * stressDifferential *
+					glm::transpose(restShapeInverse);
+				slotProducts[4 * element] =
+					-(cornerProducts[0] + cornerProducts[1] + cornerProducts[2]);
+				slotProducts[4 * element + 1] = cornerProducts[0];
+				slotProducts[4 * element + 2] = cornerProducts[1];
+				slotProducts[4 * element + 3] = cornerProducts[2];
+			}
+		}
+	);
+
+	return m_topology.getTetrahedronGatherList().gather(slotProducts, resource);
+}
+
+void CorotationalFEM::resetRotations()
+{
+	std::fill(m_rotations.begin(), m_rotations.end(), glm::quat{});
+}
+
+const std::vector<glm::quat>& CorotationalFEM::getRotations() const
+{
+	return m_rotations;
+}
+
+void CorotationalFEM::setRotations(const std::vector<glm::quat>& rotations)
+{
+	m_rotations = rotations;
+}
+
+CorotationalFEM::LameParameters CorotationalFEM::lameParameters(float youngModulus,
+	float poissonRatio)
+{
+	return
+	{
+		youngModulus / (2 * (1 + poissonRatio)),
+		youngModulus * poissonRatio / ((1 + poissonRatio) * (1 - 2 * poissonRatio))
+	};
+}
+
+void CorotationalFEM::extractRotation(const glm::mat3& deformationGradient, glm::quat& rotation)
+{
+	// Iterative rotation extraction (Müller et al. 2016). Unlike a polar decomposition it always
+	// yields a proper rotation, even for inverted elements, and converges in a few iterations when
+	// started from the previous rotation.
+	for (int i = 0; i < maxRotationIterations; ++i)
+	{
+		glm::mat3 matrix = glm::mat3_cast(rotation);
+		glm::vec3 torque = glm::cross(matrix[0], deformationGradient[0]) +
+			glm::cross(matrix[1], deformationGradient[1]) +
+			glm::cross(matrix[2], deformationGradient[2]);
+		float alignment = glm::dot(matrix[0], deformationGradient[0]) +
+			glm::dot(matrix[1], deformationGradient[1]) +
+			glm::dot(matrix[2], deformationGradient[2]);
+		glm::vec3 omega = torque / (std::abs(alignment) + 1e-9f);
+
+		float angle = glm::length(omega);
+		if (angle < rotationTolerance)
+		{
+			break;
+		}
+		rotation = glm::normalize(glm::angleAxis(angle, omega / angle) * rotation);
+	}
+}
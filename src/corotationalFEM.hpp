@@ -0,0 +1,59 @@
+#pragma once
+
+#include "latticeTopology.hpp"
+#include "state.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+// Linear tetrahedral finite elements evaluated in each element's rotated frame. The rotation is
+// extracted from the deformation gradient every evaluation, so rigid motion of an element produces
+// no force while stretch, shear and volume change are resisted according to Young's modulus and
+// Poisson's ratio.
+class CorotationalFEM
+{
+public:
+	CorotationalFEM(const LatticeTopology& topology);
+
+	std::pmr::vector<glm::vec3> getForces(const State& state, float youngModulus,
+		float poissonRatio,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+		float* energy = nullptr) const;
+	// Product of the stiffness matrix and the direction, with the element rotations of the last
+	// force evaluation.
+	std::pmr::vector<glm::vec3> getStiffnessProduct(std::span<const glm::vec3> direction,
+		float youngModulus, float poissonRatio,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	// Forgets the rotations the next evaluation would start from, so that it only depends on its
+	// arguments.
+	void resetRotations();
+	// Rotations the next evaluation starts from, to resume a run exactly.
+	const std::vector<glm::quat>& getRotations() const;
+	void setRotations(const std::vector<glm::quat>& rotations);
+
+private:
+	struct LameParameters
+	{
+		float mu{};
+		float lambda{};
+	};
+
+	static constexpr std::size_t elementGrainSize = 64;
+	static constexpr int maxRotationIterations = 8;
+	static constexpr float rotationTolerance = 1e-6f;
+
+	const LatticeTopology& m_topology;
+	std::vector<glm::mat3> m_restShapeInverses{};
+	std::vector<float> m_restVolumes{};
+
+	// Rotations from the previous evaluation, used as the starting guess of the next one.
+	mutable std::vector<glm::quat> m_rotations{};
+
+	static LameParameters lameParameters(float youngModulus, float poissonRatio);
+	static void extractRotation(const glm::mat3& deformationGradient, glm::quat& rotation);
+};
@@ -2,30 +2,31 @@
 
 #include "controlCube.hpp"
 
+#include <algorithm>
 #include <utility>
 
 ElasticCube::ElasticCube(const glm::vec3& size)
 {
-	m_vertices = createVertices(size);
+	setVertices(createVertices(size));
 }
 
-std::vector<glm::vec3> ElasticCube::getVertices() const
+std::span<const glm::vec3> ElasticCube::getVertices() const
 {
 	return m_vertices;
 }
 
-void ElasticCube::setVertices(const std::vector<glm::vec3>& vertices)
+void ElasticCube::setVertices(std::span<const glm::vec3> vertices)
 {
-	m_vertices = vertices;
+	std::copy(vertices.begin(), vertices.end(), m_vertices.begin());
+	for (std::size_t i = 0; i < cornerIndices.size(); ++i)
+	{
+		m_corners[i] = m_vertices[cornerIndices[i]];
+	}
 }
 
-std::vector<glm::vec3> ElasticCube::getCorners() const
+std::span<const glm::vec3> ElasticCube::getCorners() const
 {
-	return
-	{
-		m_vertices[0], m_vertices[3], m_vertices[12], m_vertices[15],
-		m_vertices[48], m_vertices[51], m_vertices[60], m_vertices[63]
-	};
+	return m_corners;
 }
 
 std::vector<glm::vec3> ElasticCube::createVertices(const glm::vec3& size)
@@ -51,7 +52,7 @@ std::vector<glm::vec3> ElasticCube::createCorners(const glm::vec3& size)
 {
 	std::vector<glm::vec3> vertices = createVertices(size);
 	std::vector<glm::vec3> corners{};
-	for (std::size_t index : cornerIndices())
+	for (std::size_t index : cornerIndices)
 	{
 		corners.push_back(vertices[index]);
 	}
@@ -124,12 +125,47 @@ std::vector<std::pair<std::size_t, std::size_t>> ElasticCube::createShortSprings
 	return springs;
 }
 
-std::vector<std::size_t> ElasticCube::cornerIndices()
+std::vector<std::array<std::size_t, 4>> ElasticCube::createTetrahedra()
 {
-	return {0, 3, 12, 15, 48, 51, 60, 63};
+	// Each cell is split into six tetrahedra sharing its main diagonal, one per order in which the
+	// axes are walked from the cell's first corner to the opposite one. The split is the same in
+	// every cell, so faces of neighbouring cells match.
+	static constexpr std::array<std::array<std::size_t, 3>, 6> axisOrders
+	{{
+		{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+	}};
+
+	std::vector<std::array<std::size_t, 4>> tetrahedra{};
+	for (std::size_t zi = 0; zi < 3; ++zi)
+	{
+		for (std::size_t yi = 0; yi < 3; ++yi)
+		{
+			for (std::size_t xi = 0; xi < 3; ++xi)
+			{
+				for (const std::array<std::size_t, 3>& axisOrder : axisOrders)
+				{
+					std::array<std::size_t, 3> corner{xi, yi, zi};
+					std::array<std::size_t, 4> tetrahedron{};
+					tetrahedron[0] = index(corner[0], corner[1], corner[2]);
+					for (std::size_t i = 0; i < 3; ++i)
+					{
+						++corner[axisOrder[i]];
+						tetrahedron[i + 1] = index(corner[0], corner[1], corner[2]);
+					}
+					tetrahedra.push_back(tetrahedron);
+				}
+			}
+		}
+	}
+	return tetrahedra;
 }
 
 std::size_t ElasticCube::index(std::size_t xi, std::size_t yi, std::size_t zi)
 {
 	return 16 * zi + 4 * yi + xi;
 }
+
+std::array<std::size_t, 3> ElasticCube::coordinates(std::size_t index)
+{
+	return {index % 4, index / 4 % 4, index / 16};
+}
@@ -4,26 +4,32 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <cstddef>
+#include <span>
 #include <vector>
 
 class ElasticCube
 {
 public:
+	static constexpr std::size_t resolution = 4;
+	static constexpr std::array<std::size_t, 8> cornerIndices{0, 3, 12, 15, 48, 51, 60, 63};
+
 	ElasticCube(const glm::vec3& size);
-	std::vector<glm::vec3> getVertices() const;
-	void setVertices(const std::vector<glm::vec3>& vertices);
-	std::vector<glm::vec3> getCorners() const;
+	std::span<const glm::vec3> getVertices() const;
+	void setVertices(std::span<const glm::vec3> vertices);
+	std::span<const glm::vec3> getCorners() const;
 
 	static std::vector<glm::vec3> createVertices(const glm::vec3& size);
 	static std::vector<glm::vec3> createCorners(const glm::vec3& size);
 	static std::vector<std::pair<std::size_t, std::size_t>> createSprings();
 	static std::vector<std::pair<std::size_t, std::size_t>> createShortSprings();
+	static std::vector<std::array<std::size_t, 4>> createTetrahedra();
 
-	static std::vector<std::size_t> cornerIndices();
+	static std::size_t index(std::size_t xi, std::size_t yi, std::size_t zi);
+	static std::array<std::size_t, 3> coordinates(std::size_t index);
 
 private:
-	std::vector<glm::vec3> m_vertices{};
-
-	static std::size_t index(std::size_t xi, std::size_t yi, std::size_t zi);
+	std::array<glm::vec3, resolution * resolution * resolution> m_vertices{};
+	std::array<glm::vec3, cornerIndices.size()> m_corners{};
 };
@@ -0,0 +1,155 @@
+#include "ffdMesh.hpp"
+
+#include <glad/glad.h>
+
+#include <utility>
+
+FFDMesh::FFDMesh(const std::vector<Mesh::Vertex>& vertices,
+	const std::vector<unsigned int>& indices) :
+	m_mesh{vertices, indices, GL_TRIANGLES, true},
+	m_restVertices{createRestVertices(vertices)}
+{
+	createRestSSBO();
+}
+
+FFDMesh::FFDMesh(FFDMesh&& mesh) noexcept :
+	m_mesh{std::move(mesh.m_mesh)},
+	m_restVertices{std::move(mesh.m_restVertices)},
+	m_restSSBO{mesh.m_restSSBO}
+{
+	mesh.m_isValid = false;
+}
+
+FFDMesh::~FFDMesh()
+{
+	destroyBuffers();
+}
+
+FFDMesh& FFDMesh::operator=(FFDMesh&& mesh) noexcept
+{
+	destroyBuffers();
+
+	m_mesh = std::move(mesh.m_mesh);
+	m_restVertices = std::move(mesh.m_restVertices);
+	m_restSSBO = mesh.m_restSSBO;
+	m_isValid = true;
+
+	mesh.m_isValid = false;
+
+	return *this;
+}
+
+void FFDMesh::deform(std::span<const glm::vec3> controlPoints,
+	const ShaderProgram* deformShaderProgram, std::pmr::memory_resource* resource) const
+{
+	if (deformShaderProgram && deformShaderProgram->isReady())
+	{
+		deformGPU(controlPoints, *deformShaderProgram);
+	}
+	else
+	{
+		deformCPU(controlPoints, resource);
+	}
+}
+
+void FFDMesh::render() const
+{
+	m_mesh.render();
+}
+
+void FFDMesh::createRestSSBO()
+{
+	// Uploaded through GL_ARRAY_BUFFER since GL_SHADER_STORAGE_BUFFER is not a valid target on
+	// contexts without compute support, where only the CPU path is used
+	glGenBuffers(1, &m_restSSBO);
+	glBindBuffer(GL_ARRAY_BUFFER, m_restSSBO);
+	glBufferData(GL_ARRAY_BUFFER,
+		static_cast<GLsizeiptr>(m_restVertices.size() * sizeof(RestVertex)),
+		m_restVertices.data(), GL_STATIC_DRAW);
+}
+
+void FFDMesh::deformGPU(std::span<const glm::vec3> controlPoints,
+	const ShaderProgram& deformShaderProgram) const
+{
+	GLuint vertexCount = static_cast<GLuint>(m_restVertices.size());
+
+	deformShaderProgram.use();
+	deformShaderProgram.setUniform("bezierPoints", controlPoints);
+	deformShaderProgram.setUniform("vertexCount", static_cast<int>(vertexCount));
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_restSSBO);
+	m_mesh.bindAsStorageBuffer(1);
+	glDispatchCompute((vertexCount + deformGroupSize - 1) / deformGroupSize, 1, 1);
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void FFDMesh::deformCPU(std::span<const glm::vec3> controlPoints,
+	std::pmr::memory_resource* resource) const
+{
+	std::pmr::vector<Mesh::Vertex> vertices(m_restVertices.size(), resource);
+	for (std::size_t i = 0; i < m_restVertices.size(); ++i)
+	{
+		vertices[i] = deformVertex(m_restVertices[i], controlPoints);
+	}
+	m_mesh.update(vertices);
+}
+
+void FFDMesh::destroyBuffers() const
+{
+	if (m_isValid)
+	{
+		glDeleteBuffers(1, &m_restSSBO);
+	}
+}
+
+Mesh::Vertex FFDMesh::deformVertex(const RestVertex& restVertex,
+	std::span<const glm::vec3> controlPoints)
+{
+	const BernsteinBasis& basis = restVertex.basis;
+
+	glm::vec3 pos{};
+	glm::vec3 jacobianU{};
+	glm::vec3 jacobianV{};
+	glm::vec3 jacobianW{};
+	for (int wi = 0; wi < 4; ++wi)
+	{
+		for (int vi = 0; vi < 4; ++vi)
+		{
+			glm::vec3 rowPos{};
+			glm::vec3 rowDerivU{};
+			for (int ui = 0; ui < 4; ++ui)
+			{
+				const glm::vec3& controlPoint = controlPoints[16 * wi + 4 * vi + ui];
+				rowPos += basis.u[ui] * controlPoint;
+				rowDerivU += basis.derivU[ui] * controlPoint;
+			}
+
+			float basisVW = basis.v[vi] * basis.w[wi];
+			pos += basisVW * rowPos;
+			jacobianU += basisVW * rowDerivU;
+			jacobianV += basis.derivV[vi] * basis.w[wi] * rowPos;
+			jacobianW += basis.v[vi] * basis.derivW[wi] * rowPos;
+		}
+	}
+
+	glm::vec3 cofactorU = glm::cross(jacobianV, jacobianW);
+	glm::vec3 cofactorV = glm::cross(jacobianW, jacobianU);
+	glm::vec3 cofactorW = glm::cross(jacobianU, jacobianV);
+	float determinantSign = glm::dot(jacobianU, cofactorU) < 0 ? -1.0f : 1.0f;
+	glm::vec3 normalVector = determinantSign * (restVertex.normalVector.x * cofactorU +
+		restVertex.normalVector.y * cofactorV + restVertex.normalVector.z * cofactorW);
+
+	float normalLength = glm::length(normalVector);
+	return {pos, normalLength > 0 ? normalVector / normalLength : normalVector};
+}
+
+std::vector<FFDMesh::RestVertex> FFDMesh::createRestVertices(
+	const std::vector<Mesh::Vertex>& vertices)
+{
+	std::vector<RestVertex> restVertices{};
+	restVertices.reserve(vertices.size());
+	for (const Mesh::Vertex& vertex : vertices)
+	{
+		restVertices.push_back({BernsteinBasis{vertex.pos}, glm::vec4{vertex.normalVector, 0}});
+	}
+	return restVertices;
+}
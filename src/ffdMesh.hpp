@@ -0,0 +1,55 @@
+#pragma once
+
+#include "bernsteinBasis.hpp"
+#include "mesh.hpp"
+#include "shaderProgram.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+class FFDMesh
+{
+public:
+	struct RestVertex
+	{
+		BernsteinBasis basis{};
+		glm::vec4 normalVector{};
+	};
+
+	FFDMesh(const std::vector<Mesh::Vertex>& vertices, const std::vector<unsigned int>& indices);
+	FFDMesh(const FFDMesh&) = delete;
+	FFDMesh(FFDMesh&& mesh) noexcept;
+	~FFDMesh();
+	FFDMesh& operator=(const FFDMesh&) = delete;
+	FFDMesh& operator=(FFDMesh&& mesh) noexcept;
+
+	void deform(std::span<const glm::vec3> controlPoints,
+		const ShaderProgram* deformShaderProgram,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	void render() const;
+
+private:
+	static constexpr unsigned int deformGroupSize = 64;
+
+	bool m_isValid = true;
+
+	Mesh m_mesh;
+	std::vector<RestVertex> m_restVertices{};
+	unsigned int m_restSSBO{};
+
+	void createRestSSBO();
+	void deformGPU(std::span<const glm::vec3> controlPoints,
+		const ShaderProgram& deformShaderProgram) const;
+	void deformCPU(std::span<const glm::vec3> controlPoints,
+		std::pmr::memory_resource* resource) const;
+
+	void destroyBuffers() const;
+
+	static Mesh::Vertex deformVertex(const RestVertex& restVertex,
+		std::span<const glm::vec3> controlPoints);
+	static std::vector<RestVertex> createRestVertices(const std::vector<Mesh::Vertex>& vertices);
+};
@@ -0,0 +1,50 @@
+#include "ffdModel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+FFDModel::FFDModel(std::vector<FFDMesh> lods, const ShaderProgram& shaderProgram,
+	const ShaderProgram* deformShaderProgram, const glm::vec4& color) :
+	m_lods{std::move(lods)},
+	m_shaderProgram{shaderProgram},
+	m_deformShaderProgram{deformShaderProgram},
+	m_color{color}
+{ }
+
+std::size_t FFDModel::getLODCount() const
+{
+	return m_lods.size();
+}
+
+std::size_t FFDModel::getLOD() const
+{
+	return m_lod;
+}
+
+void FFDModel::setLOD(std::size_t lod)
+{
+	m_lod = std::min(lod, m_lods.empty() ? 0 : m_lods.size() - 1);
+}
+
+void FFDModel::deform(std::span<const glm::vec3> controlPoints,
+	std::pmr::memory_resource* resource) const
+{
+	if (m_lods.empty())
+	{
+		return;
+	}
+
+	m_lods[m_lod].deform(controlPoints, m_deformShaderProgram, resource);
+}
+
+void FFDModel::render() const
+{
+	if (m_lods.empty() || !m_shaderProgram.isReady())
+	{
+		return;
+	}
+
+	m_shaderProgram.use();
+	m_shaderProgram.setUniform("color", m_color);
+	m_lods[m_lod].render();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ffdMesh.hpp"
+#include "shaderProgram.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+class FFDModel
+{
+public:
+	FFDModel(std::vector<FFDMesh> lods, const ShaderProgram& shaderProgram,
+		const ShaderProgram* deformShaderProgram, const glm::vec4& color);
+
+	std::size_t getLODCount() const;
+	std::size_t getLOD() const;
+	void setLOD(std::size_t lod);
+
+	// Scratch data of the CPU fallback is allocated from resource.
+	void deform(std::span<const glm::vec3> controlPoints,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	void render() const;
+
+private:
+	std::vector<FFDMesh> m_lods{};
+	std::size_t m_lod = 0;
+	const ShaderProgram& m_shaderProgram;
+	const ShaderProgram* m_deformShaderProgram{};
+	glm::vec4 m_color{};
+};
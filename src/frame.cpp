@@ -2,69 +2,136 @@
 
 glm::vec3 Frame::getPos() const
 {
-	return m_pos;
+	return m_pose.pos;
 }
 
 void Frame::setPos(const glm::vec3& pos)
 {
-	m_pos = pos;
-	updateMatrix();
+	m_pose.pos = pos;
+	poseChanged();
 }
 
 float Frame::getPitchRad() const
 {
-	return m_pitchRad;
+	return getAnglesRad().x;
 }
 
 void Frame::setPitchRad(float pitchRad)
 {
-	m_pitchRad = pitchRad;
-	updateMatrix();
+	glm::vec3 anglesRad = getAnglesRad();
+	anglesRad.x = pitchRad;
+	setAnglesRad(anglesRad);
 }
 
 float Frame::getYawRad() const
 {
-	return m_yawRad;
+	return getAnglesRad().y;
 }
 
 void Frame::setYawRad(float yawRad)
 {
-	m_yawRad = yawRad;
-	updateMatrix();
+	glm::vec3 anglesRad = getAnglesRad();
+	anglesRad.y = yawRad;
+	setAnglesRad(anglesRad);
 }
 
 float Frame::getRollRad() const
 {
-	return m_rollRad;
+	return getAnglesRad().z;
 }
 
 void Frame::setRollRad(float rollRad)
 {
-	m_rollRad = rollRad;
-	updateMatrix();
+	glm::vec3 anglesRad = getAnglesRad();
+	anglesRad.z = rollRad;
+	setAnglesRad(anglesRad);
+}
+
+glm::vec3 Frame::getAnglesRad() const
+{
+	if (m_anglesOutdated)
+	{
+		updateAngles();
+	}
+	return m_anglesRad;
+}
+
+void Frame::setAnglesRad(const glm::vec3& anglesRad)
+{
+	m_anglesRad = anglesRad;
+	m_anglesOutdated = false;
+	m_pose.orientation = glm::quat{anglesRad};
+	poseChanged();
 }
 
 glm::quat Frame::getOrientation() const
 {
-	return glm::vec3{m_pitchRad, m_yawRad, m_rollRad};
+	return m_pose.orientation;
+}
+
+void Frame::setOrientation(const glm::quat& orientation)
+{
+	m_pose.orientation = orientation;
+	m_anglesOutdated = true;
+	poseChanged();
+}
+
+Frame::Pose Frame::getPose() const
+{
+	return m_pose;
+}
+
+void Frame::setPose(const Pose& pose)
+{
+	m_pose = pose;
+	m_anglesOutdated = true;
+	poseChanged();
+}
+
+std::uint64_t Frame::getGeneration() const
+{
+	return m_generation;
+}
+
+Frame::Pose Frame::interpolate(const Pose& from, const Pose& to, float alpha)
+{
+	return {glm::mix(from.pos, to.pos, alpha),
+		glm::slerp(from.orientation, to.orientation, alpha)};
 }
 
 glm::mat4 Frame::getMatrix() const
 {
+	if (m_matrixOutdated)
+	{
+		updateMatrix();
+	}
 	return m_matrix;
 }
 
-void Frame::updateMatrix()
+void Frame::updateAngles() const
 {
-	glm::mat4 orientationMatrix = glm::mat4_cast(getOrientation());
+	m_anglesRad = glm::eulerAngles(m_pose.orientation);
+	m_anglesOutdated = false;
+}
+
+void Frame::updateMatrix() const
+{
+	glm::mat4 orientationMatrix = glm::mat4_cast(m_pose.orientation);
 
 	glm::mat4 posMatrix
 		{
 			1, 0, 0, 0,
 			0, 1, 0, 0,
 			0, 0, 1, 0,
-			m_pos.x, m_pos.y, m_pos.z, 1
+			m_pose.pos.x, m_pose.pos.y, m_pose.pos.z, 1
 		};
 
 	m_matrix = posMatrix * orientationMatrix;
+	m_matrixOutdated = false;
+}
+
+void Frame::poseChanged()
+{
+	m_matrixOutdated = true;
+	++m_generation;
 }
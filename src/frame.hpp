@@ -3,9 +3,17 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <cstdint>
+
 class Frame
 {
 public:
+	struct Pose
+	{
+		glm::vec3 pos{};
+		glm::quat orientation{1, 0, 0, 0};
+	};
+
 	virtual ~Frame() = default;
 
 	glm::vec3 getPos() const;
@@ -15,19 +23,36 @@ public:
 	float getYawRad() const;
 	void setYawRad(float yawRad);
 	float getRollRad() const;
-	void setRollRad(float pitchRad);
+	void setRollRad(float rollRad);
+	// Pitch, yaw and roll at once.
+	glm::vec3 getAnglesRad() const;
+	void setAnglesRad(const glm::vec3& anglesRad);
 	glm::quat getOrientation() const;
+	void setOrientation(const glm::quat& orientation);
+	Pose getPose() const;
+	// Sets position and orientation as a single pose change.
+	void setPose(const Pose& pose);
+	// Incremented on every pose change.
+	std::uint64_t getGeneration() const;
+
+	// Linear in position and spherical in orientation, alpha in [0, 1].
+	static Pose interpolate(const Pose& from, const Pose& to, float alpha);
 
 protected:
+	// Rebuilt on first use after a pose change.
 	glm::mat4 getMatrix() const;
 
 private:
-	glm::mat4 m_matrix{1};
-
-	glm::vec3 m_pos{};
-	float m_pitchRad = 0;
-	float m_yawRad = 0;
-	float m_rollRad = 0;
+	Pose m_pose{};
+	// Euler angles are kept as set so that editing one of them does not disturb the others. After
+	// the orientation was set directly they are derived from it on first use.
+	mutable glm::vec3 m_anglesRad{};
+	mutable bool m_anglesOutdated = false;
+	mutable glm::mat4 m_matrix{1};
+	mutable bool m_matrixOutdated = false;
+	std::uint64_t m_generation = 0;
 
-	void updateMatrix();
+	void updateAngles() const;
+	void updateMatrix() const;
+	void poseChanged();
 };
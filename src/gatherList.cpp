@@ -0,0 +1,27 @@
+#include "gatherList.hpp"
+
+#include "parallel.hpp"
+
+std::size_t GatherList::getSlotCount() const
+{
+	return m_slots.size();
+}
+
+std::pmr::vector<glm::vec3> GatherList::gather(std::span<const glm::vec3> slotValues,
+	std::pmr::memory_resource* resource) const
+{
+	std::pmr::vector<glm::vec3> pointValues(m_offsets.size() - 1, resource);
+	Parallel::forRange(pointValues.size(), pointGrainSize,
+		[this, &slotValues, &pointValues] (std::size_t begin, std::size_t end)
+		{
+			for (std::size_t point = begin; point < end; ++point)
+			{
+				for (std::size_t i = m_offsets[point]; i < m_offsets[point + 1]; ++i)
+				{
+					pointValues[point] += slotValues[m_slots[i]];
+				}
+			}
+		}
+	);
+	return pointValues;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+// Per-point lists of the element corner slots (elementSize * element + corner) touching each point.
+// Elements write their contributions to their own slots and every point sums its slots, so
+// accumulation parallelizes over points without atomics and always sums in the same order.
+class GatherList
+{
+public:
+	GatherList() = default;
+	template <std::size_t elementSize>
+	GatherList(const std::vector<std::array<std::size_t, elementSize>>& elements,
+		std::size_t pointCount);
+
+	std::size_t getSlotCount() const;
+	std::pmr::vector<glm::vec3> gather(std::span<const glm::vec3> slotValues,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+private:
+	static constexpr std::size_t pointGrainSize = 64;
+
+	std::vector<std::size_t> m_offsets{};
+	std::vector<std::size_t> m_slots{};
+};
+
+template <std::size_t elementSize>
+GatherList::GatherList(const std::vector<std::array<std::size_t, elementSize>>& elements,
+	std::size_t pointCount) :
+	m_offsets(pointCount + 1),
+	m_slots(elementSize * elements.size())
+{
+	for (const std::array<std::size_t, elementSize>& element : elements)
+	{
+		for (std::size_t point : element)
+		{
+			++m_offsets[point + 1];
+		}
+	}
+	for (std::size_t point = 0; point < pointCount; ++point)
+	{
+		m_offsets[point + 1] += m_offsets[point];
+	}
+
+	std::vector<std::size_t> nextSlots(m_offsets.begin(), m_offsets.end() - 1);
+	for (std::size_t element = 0; element < elements.size(); ++element)
+	{
+		for (std::size_t corner = 0; corner < elementSize; ++corner)
+		{
+			m_slots[nextSlots[elements[element][corner]]++] = elementSize * element + corner;
+		}
+	}
+}
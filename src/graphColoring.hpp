@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+class GraphColoring
+{
+public:
+	GraphColoring() = delete;
+
+	// Greedily groups elements (ranges of point indices) into batches in which no two elements
+	// share a point, so each batch can be processed in parallel without write conflicts.
+	template <typename Element>
+	static std::vector<std::vector<std::size_t>> color(const std::vector<Element>& elements,
+		std::size_t pointCount);
+
+	~GraphColoring() = delete;
+};
+
+template <typename Element>
+std::vector<std::vector<std::size_t>> GraphColoring::color(const std::vector<Element>& elements,
+	std::size_t pointCount)
+{
+	std::vector<std::vector<std::size_t>> batches{};
+	std::vector<std::vector<std::size_t>> pointColors(pointCount);
+	for (std::size_t element = 0; element < elements.size(); ++element)
+	{
+		std::size_t color = 0;
+		bool isColorUsed = true;
+		while (isColorUsed)
+		{
+			isColorUsed = false;
+			for (std::size_t point : elements[element])
+			{
+				const std::vector<std::size_t>& colors = pointColors[point];
+				if (std::find(colors.begin(), colors.end(), color) != colors.end())
+				{
+					isColorUsed = true;
+					++color;
+					break;
+				}
+			}
+		}
+
+		if (color == batches.size())
+		{
+			batches.emplace_back();
+		}
+		batches[color].push_back(element);
+		for (std::size_t point : elements[element])
+		{
+			pointColors[point].push_back(color);
+		}
+	}
+	return batches;
+}
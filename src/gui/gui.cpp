@@ -1,11 +1,15 @@
 #include "gui/gui.hpp"
 
+#include "profiler/cpuTimer.hpp"
+#include "profiler/gpuTimer.hpp"
+
 #include <imgui/backends/imgui_impl_glfw.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
 #include <imgui/imgui.h>
 
 GUI::GUI(GLFWwindow* window, Scene& scene, const glm::ivec2& viewportSize) :
-	m_leftPanel{scene, scene.getSimulation(), viewportSize}
+	m_leftPanel{scene, scene.getSimulation(), viewportSize},
+	m_profilerPanel{viewportSize}
 {
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -24,15 +28,21 @@ GUI::~GUI()
 
 void GUI::update()
 {
+	CPUTimer timer{Profiler::CPUSection::gui};
+
 	ImGui_ImplGlfw_NewFrame();
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui::NewFrame();
 
 	m_leftPanel.update();
+	m_profilerPanel.update();
 }
 
 void GUI::render()
 {
+	CPUTimer cpuTimer{Profiler::CPUSection::gui};
+	GPUTimer gpuTimer{Profiler::GPUPass::gui};
+
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
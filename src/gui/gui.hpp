@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gui/leftPanel.hpp"
+#include "gui/profilerPanel.hpp"
 #include "scene.hpp"
 
 #include <glad/glad.h>
@@ -18,4 +19,5 @@ public:
 
 private:
 	LeftPanel m_leftPanel;
+	ProfilerPanel m_profilerPanel;
 };
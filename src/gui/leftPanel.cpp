@@ -1,6 +1,7 @@
 #include "gui/leftPanel.hpp"
 
 #include "controlCube.hpp"
+#include "profiler/profiler.hpp"
 
 #include <imgui/imgui.h>
 
@@ -35,19 +36,74 @@ void LeftPanel::update()
 
 	ImGui::Text("t = %.2f", m_simulation.getT());
 
+	if (m_simulation.isRolledBack())
+	{
+		ImGui::SameLine();
+		ImGui::Text("(unstable, rolled back)");
+	}
+
 	separator();
 
-	updateInputFloat
+	if (m_simulation.getAutomaticDT() &&
+		m_simulation.getSolver() == Simulation::Solver::rungeKutta4)
+	{
+		ImGui::Text("dt = %.4f", m_simulation.getDT());
+	}
+	else
+	{
+		updateInputFloat
+		(
+			[this] () { return m_simulation.getDT(); },
+			[this] (float dt) { m_simulation.setDT(dt); },
+			"dt",
+			0.001f,
+			std::nullopt,
+			"%.3f",
+			0.001f
+		);
+	}
+
+	updateCheckbox
 	(
-		[this] () { return m_simulation.getDT(); },
-		[this] (float dt) { m_simulation.setDT(dt); },
-		"dt",
-		0.001f,
-		std::nullopt,
-		"%.3f",
-		0.001f
+		[this] () { return m_simulation.getAutomaticDT(); },
+		[this] (bool automaticDT) { m_simulation.setAutomaticDT(automaticDT); },
+		"automatic dt"
+	);
+
+	ImGui::Text("stable RK4 dt: %.4f", m_simulation.getStableDT());
+
+	updateCombo
+	(
+		[this] () { return static_cast<int>(m_simulation.getSolver()); },
+		[this] (int solver) { m_simulation.setSolver(static_cast<Simulation::Solver>(solver)); },
+		"solver",
+		{"Runge-Kutta 4", "XPBD"}
 	);
 
+	if (m_simulation.getSolver() == Simulation::Solver::xpbd)
+	{
+		updateInputInt
+		(
+			[this] () { return m_simulation.getXPBDIterations(); },
+			[this] (int xpbdIterations) { m_simulation.setXPBDIterations(xpbdIterations); },
+			"XPBD iterations",
+			1,
+			1
+		);
+
+		updateInputInt
+		(
+			[this] () { return m_simulation.getXPBDLevels(); },
+			[this] (int xpbdLevels)
+			{
+				m_simulation.setXPBDLevels(std::min(xpbdLevels, m_simulation.getMaxXPBDLevels()));
+			},
+			"XPBD levels",
+			1,
+			1
+		);
+	}
+
 	updateInputFloat
 	(
 		[this] () { return m_simulation.getMass(); },
@@ -56,13 +112,60 @@ void LeftPanel::update()
 		0.1f
 	);
 
-	updateInputFloat
-	(
-		[this] () { return m_simulation.getInternalStiffness(); },
-		[this] (float internalStiffness) { m_simulation.setInternalStiffness(internalStiffness); },
-		"internal stiffness",
-		0.1f
-	);
+	// XPBD always solves the lattice springs, the material model only applies to RK4.
+	bool xpbd = m_simulation.getSolver() == Simulation::Solver::xpbd;
+	if (!xpbd)
+	{
+		updateCombo
+		(
+			[this] () { return static_cast<int>(m_simulation.getMaterialModel()); },
+			[this] (int materialModel)
+			{
+				m_simulation.setMaterialModel(
+					static_cast<Simulation::MaterialModel>(materialModel));
+			},
+			"material model",
+			{"springs", "corotational FEM"}
+		);
+	}
+
+	if (xpbd || m_simulation.getMaterialModel() == Simulation::MaterialModel::springs)
+	{
+		updateInputFloat
+		(
+			[this] () { return m_simulation.getInternalStiffness(); },
+			[this] (float internalStiffness)
+			{
+				m_simulation.setInternalStiffness(internalStiffness);
+			},
+			"internal stiffness",
+			0.1f
+		);
+	}
+	else
+	{
+		updateInputFloat
+		(
+			[this] () { return m_simulation.getYoungModulus(); },
+			[this] (float youngModulus) { m_simulation.setYoungModulus(youngModulus); },
+			"Young's modulus",
+			0.1f,
+			std::nullopt,
+			"%.1f",
+			10.0f
+		);
+
+		updateInputFloat
+		(
+			[this] () { return m_simulation.getPoissonRatio(); },
+			[this] (float poissonRatio) { m_simulation.setPoissonRatio(poissonRatio); },
+			"Poisson's ratio",
+			0.0f,
+			0.45f,
+			"%.2f",
+			0.01f
+		);
+	}
 
 	updateInputFloat
 	(
@@ -72,6 +175,17 @@ void LeftPanel::update()
 		0.1f
 	);
 
+	updateInputFloat
+	(
+		[this] () { return m_simulation.getExternalDamping(); },
+		[this] (float externalDamping) { m_simulation.setExternalDamping(externalDamping); },
+		"external damping",
+		0.0f,
+		std::nullopt,
+		"%.2f",
+		0.01f
+	);
+
 	updateInputFloat
 	(
 		[this] () { return m_simulation.getDamping(); },
@@ -122,6 +236,39 @@ void LeftPanel::update()
 		"gravity"
 	);
 
+	updateCheckbox
+	(
+		[this] () { return m_simulation.getSleeping(); },
+		[this] (bool sleeping) { m_simulation.setSleeping(sleeping); },
+		"sleeping"
+	);
+
+	if (m_simulation.isAsleep())
+	{
+		ImGui::SameLine();
+		ImGui::Text("(asleep)");
+	}
+
+	updateCheckbox
+	(
+		[this] () { return m_simulation.getRenderInterpolation(); },
+		[this] (bool renderInterpolation)
+		{
+			m_simulation.setRenderInterpolation(renderInterpolation);
+		},
+		"render interpolation"
+	);
+
+	updateCheckbox
+	(
+		[this] () { return m_simulation.getInstabilityDetection(); },
+		[this] (bool instabilityDetection)
+		{
+			m_simulation.setInstabilityDetection(instabilityDetection);
+		},
+		"instability detection"
+	);
+
 	updateCheckbox
 	(
 		[this] () { return m_scene.getRenderMassPoints(); },
@@ -150,6 +297,12 @@ void LeftPanel::update()
 		"render teapot"
 	);
 
+	if (m_scene.isLoadingAssets())
+	{
+		ImGui::SameLine();
+		ImGui::Text("(loading)");
+	}
+
 	updateCheckbox
 	(
 		[this] () { return m_scene.getRenderInternalSprings(); },
@@ -177,10 +330,74 @@ void LeftPanel::update()
 		"render external springs"
 	);
 
+	updateCheckbox
+	(
+		[] () { return Profiler::isEnabled(); },
+		[] (bool profiler) { Profiler::setEnabled(profiler); },
+		"profiler"
+	);
+
+	if (Profiler::isEnabled())
+	{
+		updateArenaStats("step arena", m_simulation.getStepArena());
+		updateArenaStats("frame arena", m_scene.getFrameArena());
+	}
+
+	separator();
+
+	updateInputFloat
+	(
+		[this] () { return m_scene.getMinTessLevel(); },
+		[this] (float minTessLevel) { m_scene.setMinTessLevel(minTessLevel); },
+		"min tessellation level",
+		1.0f,
+		64.0f,
+		"%.0f",
+		1.0f
+	);
+
+	updateInputFloat
+	(
+		[this] () { return m_scene.getMaxTessLevel(); },
+		[this] (float maxTessLevel) { m_scene.setMaxTessLevel(maxTessLevel); },
+		"max tessellation level",
+		1.0f,
+		64.0f,
+		"%.0f",
+		1.0f
+	);
+
+	separator();
+
+	updateInputFloat
+	(
+		[this] () { return m_scene.getLODDistance(); },
+		[this] (float lodDistance) { m_scene.setLODDistance(lodDistance); },
+		"LOD distance",
+		0.1f,
+		std::nullopt,
+		"%.1f",
+		1.0f
+	);
+
+	ImGui::Text("teapot LOD: %zu", m_scene.getTeapotLOD());
+
 	separator();
 
 	ImGui::Text("Control cube");
 
+	updateCombo
+	(
+		[this] () { return static_cast<int>(m_simulation.getControlCubeTrajectory()); },
+		[this] (int trajectory)
+		{
+			m_simulation.setControlCubeTrajectory(
+				static_cast<Simulation::ControlCubeTrajectory>(trajectory));
+		},
+		"trajectory",
+		{"none", "shake", "orbit"}
+	);
+
 	updateDragFloat
 	(
 		[this] () { return m_scene.getSimulation().getControlCube().getPos().x; },
@@ -266,6 +483,73 @@ void LeftPanel::update()
 		m_simulation.disturb();
 	}
 
+	separator();
+
+	if (m_simulation.isRecording())
+	{
+		if (ImGui::Button("Stop recording"))
+		{
+			m_simulation.stopRecording();
+		}
+	}
+	else if (ImGui::Button("Record"))
+	{
+		m_simulation.startRecording();
+	}
+
+	if (m_simulation.getRecording().has_value())
+	{
+		ImGui::SameLine();
+		if (m_simulation.isReplaying())
+		{
+			if (ImGui::Button("Stop replay"))
+			{
+				m_simulation.stopReplay();
+			}
+		}
+		else if (ImGui::Button("Replay"))
+		{
+			m_simulation.startReplay();
+		}
+
+		ImGui::SameLine();
+		if (ImGui::Button("Save"))
+		{
+			m_simulation.saveRecording(recordingPath);
+		}
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Load"))
+	{
+		m_simulation.loadRecording(recordingPath);
+	}
+
+	if (m_simulation.getRecording().has_value())
+	{
+		ImGui::Text("recording: %llu steps, %zu inputs",
+			static_cast<unsigned long long>(m_simulation.getRecording()->getStepCount()),
+			m_simulation.getRecording()->getEvents().size());
+	}
+
+	separator();
+
+	updateDiagnosticsHistories();
+	updateCheckbox
+	(
+		[this] () { return m_showDiagnostics; },
+		[this] (bool showDiagnostics) { m_showDiagnostics = showDiagnostics; },
+		"diagnostics"
+	);
+
+	if (m_showDiagnostics)
+	{
+		updatePlot("kinetic energy", m_kineticEnergyHistory);
+		updatePlot("potential energy", m_potentialEnergyHistory);
+		updatePlot("total energy", m_totalEnergyHistory);
+		updatePlot("momentum", m_momentumHistory);
+	}
+
 	ImGui::End();
 }
 
@@ -297,10 +581,10 @@ void LeftPanel::updateInputFloat(const std::function<float()>& get,
 }
 
 void LeftPanel::updateInputInt(const std::function<int()>& get,
-	const std::function<void(int)>& set, const std::string& name, std::optional<int> min)
+	const std::function<void(int)>& set, const std::string& name, std::optional<int> min,
+	int step)
 {
 	static const std::string suffix = "##leftPanelInputInt";
-	static constexpr int step = 100;
 
 	ImGui::PushItemWidth(100);
 
@@ -353,6 +637,59 @@ void LeftPanel::updateCheckbox(const std::function<bool()>& get,
 	}
 }
 
+void LeftPanel::updateCombo(const std::function<int()>& get, const std::function<void(int)>& set,
+	const std::string& name, const std::vector<const char*>& items)
+{
+	static const std::string suffix = "##leftPanelCombo";
+
+	ImGui::PushItemWidth(160);
+
+	int value = get();
+	int prevValue = value;
+	ImGui::Combo((name + suffix).c_str(), &value, items.data(), static_cast<int>(items.size()));
+	if (value != prevValue)
+	{
+		set(value);
+	}
+
+	ImGui::PopItemWidth();
+}
+
+void LeftPanel::updateDiagnosticsHistories()
+{
+	if (m_diagnosticsGeneration == m_simulation.getStateGeneration())
+	{
+		return;
+	}
+	m_diagnosticsGeneration = m_simulation.getStateGeneration();
+
+	const Simulation::Diagnostics& diagnostics = m_simulation.getDiagnostics();
+	m_kineticEnergyHistory.push(diagnostics.kineticEnergy);
+	m_potentialEnergyHistory.push(diagnostics.getPotentialEnergy());
+	m_totalEnergyHistory.push(diagnostics.getTotalEnergy());
+	m_momentumHistory.push(glm::length(diagnostics.momentum));
+}
+
+void LeftPanel::updatePlot(const char* name, const SampleHistory& history)
+{
+	static constexpr float plotHeight = 40;
+
+	ImGui::Text("%s: %.4g", name, history.latest());
+	std::string label = std::string{"##leftPanel"} + name;
+	ImGui::PlotLines(label.c_str(), history.data(), history.size(), history.offset(), nullptr,
+		std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), {0, plotHeight});
+}
+
+void LeftPanel::updateArenaStats(const char* name, const Arena& arena)
+{
+	static constexpr float kib = 1024;
+
+	ImGui::Text("%s: %zu allocs, %.1f / %.1f KiB", name, arena.getAllocationCount(),
+		arena.getUsedBytes() / kib, arena.getCapacity() / kib);
+	ImGui::Text("  peak %.1f KiB, %zu heap allocs", arena.getPeakBytes() / kib,
+		arena.getOverflowCount());
+}
+
 void LeftPanel::separator()
 {
 	ImGui::Spacing();
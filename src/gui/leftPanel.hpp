@@ -1,18 +1,23 @@
 #pragma once
 
+#include "arena.hpp"
+#include "profiler/sampleHistory.hpp"
 #include "scene.hpp"
 #include "simulation.hpp"
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
+#include <vector>
 
 class LeftPanel
 {
 public:
 	static constexpr int width = 360;
+	static constexpr const char* recordingPath = "recording.txt";
 
 	LeftPanel(Scene& scene, Simulation& simulation, const glm::ivec2& viewportSize);
 	void update();
@@ -22,16 +27,29 @@ private:
 	Simulation& m_simulation;
 	const glm::ivec2& m_viewportSize;
 
+	bool m_showDiagnostics = false;
+	// Sampled once per frame that stepped the simulation.
+	std::uint64_t m_diagnosticsGeneration = Simulation::noGeneration;
+	SampleHistory m_kineticEnergyHistory{};
+	SampleHistory m_potentialEnergyHistory{};
+	SampleHistory m_totalEnergyHistory{};
+	SampleHistory m_momentumHistory{};
+
 	void updateInputFloat(const std::function<float()>& get, const std::function<void(float)>& set,
 		const std::string& name, std::optional<float> min = std::nullopt,
 		std::optional<float> max = std::nullopt, const std::string& format = "%.1f",
 		float step = 0.1f);
 	void updateInputInt(const std::function<int()>& get, const std::function<void(int)>& set,
-		const std::string& name, std::optional<int> min = std::nullopt);
+		const std::string& name, std::optional<int> min = std::nullopt, int step = 100);
 	void updateDragFloat(const std::function<float()>& get, const std::function<void(float)>& set,
 		const std::string& name, float velocity = 0.1f);
 	void updateCheckbox(const std::function<bool()>& get, const std::function<void(bool)>& set,
 		const std::string& name);
+	void updateCombo(const std::function<int()>& get, const std::function<void(int)>& set,
+		const std::string& name, const std::vector<const char*>& items);
+	void updateArenaStats(const char* name, const Arena& arena);
+	void updateDiagnosticsHistories();
+	void updatePlot(const char* name, const SampleHistory& history);
 	void separator();
 
 	static void normalizeAngle(float& angleDeg);
@@ -0,0 +1,86 @@
+#include "gui/profilerPanel.hpp"
+
+#include "gui/leftPanel.hpp"
+#include "profiler/profiler.hpp"
+
+#include <imgui/imgui.h>
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+ProfilerPanel::ProfilerPanel(const glm::ivec2& viewportSize) :
+	m_viewportSize{viewportSize}
+{ }
+
+void ProfilerPanel::update()
+{
+	if (!Profiler::isEnabled())
+	{
+		return;
+	}
+
+	static constexpr float margin = 10;
+	ImGui::SetNextWindowPos({LeftPanel::width + m_viewportSize.x - width - margin, margin},
+		ImGuiCond_Always);
+	ImGui::SetNextWindowSize({width, 0}, ImGuiCond_Always);
+	ImGui::SetNextWindowBgAlpha(0.7f);
+	ImGui::Begin("profiler", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoTitleBar |
+		ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav);
+
+	bool csvOutput = Profiler::getCSVOutput();
+	if (ImGui::Checkbox("CSV##profilerPanel", &csvOutput))
+	{
+		Profiler::setCSVOutput(csvOutput);
+	}
+	ImGui::SameLine();
+	bool traceOutput = Profiler::getTraceOutput();
+	if (ImGui::Checkbox("Chrome trace##profilerPanel", &traceOutput))
+	{
+		Profiler::setTraceOutput(traceOutput);
+	}
+	ImGui::SameLine();
+	ImGui::Checkbox("histograms##profilerPanel", &m_showHistograms);
+
+	ImGui::Spacing();
+	ImGui::Text("CPU [ms]");
+	for (std::size_t i = 0; i < static_cast<std::size_t>(Profiler::CPUSection::count); ++i)
+	{
+		Profiler::CPUSection section = static_cast<Profiler::CPUSection>(i);
+		updateSection(Profiler::getName(section), Profiler::getHistory(section));
+	}
+
+	ImGui::Spacing();
+	ImGui::Text("GPU [ms]");
+	for (std::size_t i = 0; i < static_cast<std::size_t>(Profiler::GPUPass::count); ++i)
+	{
+		Profiler::GPUPass pass = static_cast<Profiler::GPUPass>(i);
+		updateSection(Profiler::getName(pass), Profiler::getHistory(pass));
+	}
+
+	ImGui::End();
+}
+
+void ProfilerPanel::updateSection(const char* name, const SampleHistory& history)
+{
+	static constexpr float plotWidth = 200;
+	static constexpr float plotHeight = 24;
+
+	float max = history.max();
+	ImGui::Text("%-16s %6.3f avg %6.3f max %6.3f", name, history.latest(), history.average(),
+		max);
+
+	std::string label = std::string{"##profilerPanel"} + name;
+	if (m_showHistograms)
+	{
+		std::array<float, SampleHistory::histogramBins> histogram = history.histogram(max);
+		ImGui::PlotHistogram(label.c_str(), histogram.data(), static_cast<int>(histogram.size()),
+			0, nullptr, 0, std::numeric_limits<float>::max(), {plotWidth, plotHeight});
+	}
+	else
+	{
+		ImGui::PlotLines(label.c_str(), history.data(), history.size(), history.offset(),
+			nullptr, 0, max, {plotWidth, plotHeight});
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "profiler/sampleHistory.hpp"
+
+#include <glm/glm.hpp>
+
+class ProfilerPanel
+{
+public:
+	static constexpr int width = 420;
+
+	ProfilerPanel(const glm::ivec2& viewportSize);
+	void update();
+
+private:
+	const glm::ivec2& m_viewportSize;
+	bool m_showHistograms = false;
+
+	void updateSection(const char* name, const SampleHistory& history);
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct IndexedMesh
+{
+	std::vector<Mesh::Vertex> vertices{};
+	std::vector<unsigned int> indices{};
+	// Per-vertex texture coordinates, empty if the source has none.
+	std::vector<glm::vec2> texCoords{};
+};
@@ -0,0 +1,156 @@
+#include "inputRecording.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+InputRecording::InputRecording(std::uint32_t seed, const State& initialState) :
+	m_seed{seed},
+	m_initialState{initialState}
+{ }
+
+std::uint32_t InputRecording::getSeed() const
+{
+	return m_seed;
+}
+
+const State& InputRecording::getInitialState() const
+{
+	return m_initialState;
+}
+
+const std::vector<InputRecording::Event>& InputRecording::getEvents() const
+{
+	return m_events;
+}
+
+void InputRecording::addEvent(const Event& event)
+{
+	m_events.push_back(event);
+	m_stepCount = std::max(m_stepCount, event.step);
+}
+
+std::uint64_t InputRecording::getStepCount() const
+{
+	return m_stepCount;
+}
+
+void InputRecording::setStepCount(std::uint64_t stepCount)
+{
+	m_stepCount = std::max(stepCount, m_events.empty() ? 0 : m_events.back().step);
+}
+
+void InputRecording::truncate(std::size_t eventCount, std::uint64_t stepCount)
+{
+	m_events.resize(std::min(eventCount, m_events.size()));
+	m_stepCount = 0;
+	setStepCount(stepCount);
+}
+
+bool InputRecording::save(const std::string& path) const
+{
+	std::ofstream file{path};
+	if (!file)
+	{
+		std::cerr << "Error writing input recording:\n" << path << '\n';
+		return false;
+	}
+
+	// Written with enough digits to read back the exact floats, which replay depends on.
+	file.precision(std::numeric_limits<float>::max_digits10);
+	file << "seed " << m_seed << '\n';
+	file << "steps " << m_stepCount << '\n';
+	for (std::size_t i = 0; i < m_initialState.poss.size(); ++i)
+	{
+		const glm::vec3& pos = m_initialState.poss[i];
+		const glm::vec3& velocity = m_initialState.velocities[i];
+		file << "point " << pos.x << ' ' << pos.y << ' ' << pos.z << ' ' << velocity.x << ' ' <<
+			velocity.y << ' ' << velocity.z << '\n';
+	}
+	for (const Event& event : m_events)
+	{
+		file << "event " << event.step << ' ' <<
+			inputNames[static_cast<std::size_t>(event.input)] << ' ' << event.value.x << ' ' <<
+			event.value.y << ' ' << event.value.z << '\n';
+	}
+	return true;
+}
+
+std::optional<InputRecording> InputRecording::load(const std::string& path)
+{
+	std::ifstream file{path};
+	if (!file)
+	{
+		std::cerr << "File does not exist:\n" << path << '\n';
+		return std::nullopt;
+	}
+
+	InputRecording recording{0, State{}};
+	std::uint64_t stepCount = 0;
+	std::size_t pointCount = 0;
+	std::string line{};
+	while (std::getline(file, line))
+	{
+		std::istringstream stream{line};
+		std::string keyword{};
+		stream >> keyword;
+		if (keyword == "seed")
+		{
+			stream >> recording.m_seed;
+		}
+		else if (keyword == "steps")
+		{
+			stream >> stepCount;
+		}
+		else if (keyword == "point" && pointCount < recording.m_initialState.poss.size())
+		{
+			glm::vec3& pos = recording.m_initialState.poss[pointCount];
+			glm::vec3& velocity = recording.m_initialState.velocities[pointCount];
+			stream >> pos.x >> pos.y >> pos.z >> velocity.x >> velocity.y >> velocity.z;
+			++pointCount;
+		}
+		else if (keyword == "event")
+		{
+			Event event{};
+			std::string name{};
+			stream >> event.step >> name >> event.value.x >> event.value.y >> event.value.z;
+			std::optional<Input> input = parseInput(name);
+			if (!input || (!recording.m_events.empty() &&
+				event.step < recording.m_events.back().step))
+			{
+				std::cerr << "Error parsing input recording, invalid event:\n" << line << '\n';
+				return std::nullopt;
+			}
+			event.input = *input;
+			recording.addEvent(event);
+		}
+
+		if (!keyword.empty() && !stream)
+		{
+			std::cerr << "Error parsing input recording, invalid line:\n" << line << '\n';
+			return std::nullopt;
+		}
+	}
+
+	if (pointCount != recording.m_initialState.poss.size())
+	{
+		std::cerr << "Error parsing input recording, incomplete initial state:\n" << path <<
+			'\n';
+		return std::nullopt;
+	}
+	recording.setStepCount(stepCount);
+	return recording;
+}
+
+std::optional<InputRecording::Input> InputRecording::parseInput(const std::string& name)
+{
+	auto found = std::find_if(inputNames.begin(), inputNames.end(),
+		[&name] (const char* inputName) { return name == inputName; });
+	if (found == inputNames.end())
+	{
+		return std::nullopt;
+	}
+	return static_cast<Input>(found - inputNames.begin());
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "state.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Simulation inputs keyed by the step they were applied before, together with the state and random
+// seed the recording started from. Replaying it reproduces the recorded run step for step,
+// independently of the frame rate it was recorded at.
+class InputRecording
+{
+public:
+	enum class Input
+	{
+		dT,
+		mass,
+		internalStiffness,
+		externalStiffness,
+		externalDamping,
+		damping,
+		materialModel,
+		youngModulus,
+		poissonRatio,
+		solver,
+		xpbdIterations,
+		xpbdLevels,
+		collisionElasticity,
+		disturbanceVelocity,
+		externalSprings,
+		gravity,
+		sleeping,
+		trajectory,
+		controlCubePos,
+		controlCubeAngles,
+		disturb,
+		count
+	};
+
+	// Scalar inputs are stored in value.x, booleans and enumerations as their numeric value.
+	struct Event
+	{
+		std::uint64_t step{};
+		Input input{};
+		glm::vec3 value{};
+	};
+
+	InputRecording(std::uint32_t seed, const State& initialState);
+
+	std::uint32_t getSeed() const;
+	const State& getInitialState() const;
+	const std::vector<Event>& getEvents() const;
+	void addEvent(const Event& event);
+	// Number of steps the recording covers, at least up to its last event.
+	std::uint64_t getStepCount() const;
+	void setStepCount(std::uint64_t stepCount);
+	// Keeps the first eventCount events and ends the recording at stepCount.
+	void truncate(std::size_t eventCount, std::uint64_t stepCount);
+
+	bool save(const std::string& path) const;
+	static std::optional<InputRecording> load(const std::string& path);
+
+private:
+	static constexpr std::array<const char*, static_cast<std::size_t>(Input::count)> inputNames
+	{
+		"dT", "mass", "internalStiffness", "externalStiffness", "externalDamping", "damping",
+		"materialModel", "youngModulus", "poissonRatio", "solver", "xpbdIterations", "xpbdLevels",
+		"collisionElasticity", "disturbanceVelocity", "externalSprings", "gravity", "sleeping",
+		"trajectory", "controlCubePos", "controlCubeAngles", "disturb"
+	};
+
+	std::uint32_t m_seed{};
+	State m_initialState{};
+	std::vector<Event> m_events{};
+	std::uint64_t m_stepCount{};
+
+	static std::optional<Input> parseInput(const std::string& name);
+};
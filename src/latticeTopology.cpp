@@ -0,0 +1,196 @@
+#include "latticeTopology.hpp"
+
+#include "elasticCube.hpp"
+#include "graphColoring.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <utility>
+
+LatticeTopology::LatticeTopology(const std::vector<glm::vec3>& restPoss) :
+	m_restPoss{restPoss},
+	m_tetrahedra{ElasticCube::createTetrahedra()}
+{
+	for (const std::pair<std::size_t, std::size_t>& spring : ElasticCube::createSprings())
+	{
+		m_springs.push_back({spring.first, spring.second});
+		m_springRestLengths.push_back(glm::length(restPoss[spring.second] -
+			restPoss[spring.first]));
+	}
+
+	m_springBatches = GraphColoring::color(m_springs, restPoss.size());
+	m_springGatherList = GatherList{m_springs, restPoss.size()};
+	m_tetrahedronBatches = GraphColoring::color(m_tetrahedra, restPoss.size());
+	m_tetrahedronGatherList = GatherList{m_tetrahedra, restPoss.size()};
+
+	std::vector<std::size_t> axisIndices(ElasticCube::resolution);
+	std::iota(axisIndices.begin(), axisIndices.end(), 0);
+	while (axisIndices.size() > 2)
+	{
+		axisIndices = coarsen(axisIndices);
+		m_coarseLevels.push_back(createLevel(axisIndices));
+	}
+}
+
+std::size_t LatticeTopology::getPointCount() const
+{
+	return m_restPoss.size();
+}
+
+const std::vector<glm::vec3>& LatticeTopology::getRestPoss() const
+{
+	return m_restPoss;
+}
+
+const std::vector<LatticeTopology::Spring>& LatticeTopology::getSprings() const
+{
+	return m_springs;
+}
+
+const std::vector<float>& LatticeTopology::getSpringRestLengths() const
+{
+	return m_springRestLengths;
+}
+
+const std::vector<std::vector<std::size_t>>& LatticeTopology::getSpringBatches() const
+{
+	return m_springBatches;
+}
+
+const GatherList& LatticeTopology::getSpringGatherList() const
+{
+	return m_springGatherList;
+}
+
+const std::vector<LatticeTopology::Tetrahedron>& LatticeTopology::getTetrahedra() const
+{
+	return m_tetrahedra;
+}
+
+const std::vector<std::vector<std::size_t>>& LatticeTopology::getTetrahedronBatches() const
+{
+	return m_tetrahedronBatches;
+}
+
+const GatherList& LatticeTopology::getTetrahedronGatherList() const
+{
+	return m_tetrahedronGatherList;
+}
+
+const std::vector<LatticeTopology::Level>& LatticeTopology::getCoarseLevels() const
+{
+	return m_coarseLevels;
+}
+
+LatticeTopology::Level LatticeTopology::createLevel(
+	const std::vector<std::size_t>& axisIndices) const
+{
+	static constexpr std::array<std::array<int, 3>, 9> springDirections
+	{{
+		{1, 0, 0}, {0, 1, 0}, {0, 0, 1},
+		{1, 1, 0}, {1, -1, 0}, {0, 1, 1}, {0, 1, -1}, {1, 0, 1}, {-1, 0, 1}
+	}};
+
+	// The block of every lattice cell, counted along each axis.
+	std::vector<std::size_t> cellBlocks(ElasticCube::resolution - 1);
+	for (std::size_t i = 0; i < cellBlocks.size(); ++i)
+	{
+		std::size_t block = 0;
+		while (block + 2 < axisIndices.size() && axisIndices[block + 1] <= i)
+		{
+			++block;
+		}
+		cellBlocks[i] = block;
+	}
+	std::size_t blocksPerAxis = axisIndices.size() - 1;
+
+	// Elements are assigned to the block of the cell at their lowest coordinates, which contains
+	// them even where they lie on a block boundary.
+	auto block = [&cellBlocks, blocksPerAxis] (std::span<const std::size_t> points)
+	{
+		std::array<std::size_t, 3> cell{};
+		cell.fill(ElasticCube::resolution - 2);
+		for (std::size_t point : points)
+		{
+			std::array<std::size_t, 3> coordinates = ElasticCube::coordinates(point);
+			for (std::size_t axis = 0; axis < 3; ++axis)
+			{
+				cell[axis] = std::min(cell[axis], coordinates[axis]);
+			}
+		}
+		return (cellBlocks[cell[2]] * blocksPerAxis + cellBlocks[cell[1]]) * blocksPerAxis +
+			cellBlocks[cell[0]];
+	};
+	std::size_t blockCount = blocksPerAxis * blocksPerAxis * blocksPerAxis;
+
+	std::vector<Aggregate> springAggregates(blockCount * springDirections.size());
+	for (std::size_t i = 0; i < m_springs.size(); ++i)
+	{
+		std::array<std::size_t, 3> from = ElasticCube::coordinates(m_springs[i][0]);
+		std::array<std::size_t, 3> to = ElasticCube::coordinates(m_springs[i][1]);
+		std::array<int, 3> direction{};
+		std::array<int, 3> oppositeDirection{};
+		for (std::size_t axis = 0; axis < 3; ++axis)
+		{
+			direction[axis] = static_cast<int>(to[axis]) - static_cast<int>(from[axis]);
+			oppositeDirection[axis] = -direction[axis];
+		}
+		std::size_t directionIndex = static_cast<std::size_t>(std::find_if(
+			springDirections.begin(), springDirections.end(),
+			[&direction, &oppositeDirection] (const std::array<int, 3>& springDirection)
+			{
+				return springDirection == direction || springDirection == oppositeDirection;
+			}
+		) - springDirections.begin());
+
+		Aggregate& aggregate =
+			springAggregates[block(m_springs[i]) * springDirections.size() + directionIndex];
+		aggregate.constraints.push_back(i);
+		aggregate.points.insert(aggregate.points.end(), m_springs[i].begin(), m_springs[i].end());
+	}
+
+	std::vector<Aggregate> tetrahedronAggregates(blockCount);
+	for (std::size_t i = 0; i < m_tetrahedra.size(); ++i)
+	{
+		Aggregate& aggregate = tetrahedronAggregates[block(m_tetrahedra[i])];
+		aggregate.constraints.push_back(i);
+		aggregate.points.insert(aggregate.points.end(), m_tetrahedra[i].begin(),
+			m_tetrahedra[i].end());
+	}
+
+	Level level{};
+	auto addAggregates =
+		[] (std::vector<Aggregate>& aggregates, std::vector<Aggregate>& levelAggregates)
+		{
+			for (Aggregate& aggregate : aggregates)
+			{
+				if (aggregate.constraints.empty())
+				{
+					continue;
+				}
+				std::vector<std::size_t>& points = aggregate.points;
+				std::sort(points.begin(), points.end());
+				points.erase(std::unique(points.begin(), points.end()), points.end());
+				levelAggregates.push_back(std::move(aggregate));
+			}
+		};
+	addAggregates(springAggregates, level.springAggregates);
+	addAggregates(tetrahedronAggregates, level.tetrahedronAggregates);
+	return level;
+}
+
+std::vector<std::size_t> LatticeTopology::coarsen(const std::vector<std::size_t>& axisIndices)
+{
+	// Every other index, always keeping the last one so the level spans the whole lattice.
+	std::vector<std::size_t> coarseIndices{};
+	for (std::size_t i = 0; i < axisIndices.size(); i += 2)
+	{
+		coarseIndices.push_back(axisIndices[i]);
+	}
+	if (coarseIndices.back() != axisIndices.back())
+	{
+		coarseIndices.push_back(axisIndices.back());
+	}
+	return coarseIndices;
+}
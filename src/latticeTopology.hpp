@@ -0,0 +1,71 @@
+#pragma once
+
+#include "gatherList.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Connectivity of the elastic cube lattice computed once up front: springs with their rest
+// lengths, tetrahedra, conflict-free batches of both for Gauss-Seidel style solvers, per-point
+// gather lists for parallel force accumulation and a hierarchy of coarser lattices.
+class LatticeTopology
+{
+public:
+	using Spring = std::array<std::size_t, 2>;
+	using Tetrahedron = std::array<std::size_t, 4>;
+
+	// Lattice constraints that a coarse level moves together, by changing all of their
+	// multipliers by the same amount.
+	struct Aggregate
+	{
+		std::vector<std::size_t> constraints{};
+		// Points the constraints act on, each listed once.
+		std::vector<std::size_t> points{};
+	};
+
+	// Coarser lattice whose cells are blocks of lattice cells. Every block aggregates its springs
+	// of each direction and its tetrahedra, so a level constraint stretches, shears or compresses
+	// the whole block.
+	struct Level
+	{
+		std::vector<Aggregate> springAggregates{};
+		std::vector<Aggregate> tetrahedronAggregates{};
+	};
+
+	LatticeTopology(const std::vector<glm::vec3>& restPoss);
+
+	std::size_t getPointCount() const;
+	const std::vector<glm::vec3>& getRestPoss() const;
+
+	const std::vector<Spring>& getSprings() const;
+	const std::vector<float>& getSpringRestLengths() const;
+	const std::vector<std::vector<std::size_t>>& getSpringBatches() const;
+	const GatherList& getSpringGatherList() const;
+
+	const std::vector<Tetrahedron>& getTetrahedra() const;
+	const std::vector<std::vector<std::size_t>>& getTetrahedronBatches() const;
+	const GatherList& getTetrahedronGatherList() const;
+
+	// Successively coarser levels, not including the lattice itself.
+	const std::vector<Level>& getCoarseLevels() const;
+
+private:
+	std::vector<glm::vec3> m_restPoss{};
+
+	std::vector<Spring> m_springs{};
+	std::vector<float> m_springRestLengths{};
+	std::vector<std::vector<std::size_t>> m_springBatches{};
+	GatherList m_springGatherList{};
+
+	std::vector<Tetrahedron> m_tetrahedra{};
+	std::vector<std::vector<std::size_t>> m_tetrahedronBatches{};
+	GatherList m_tetrahedronGatherList{};
+
+	std::vector<Level> m_coarseLevels{};
+
+	Level createLevel(const std::vector<std::size_t>& axisIndices) const;
+	static std::vector<std::size_t> coarsen(const std::vector<std::size_t>& axisIndices);
+};
@@ -1,5 +1,7 @@
 #include "gui/gui.hpp"
+#include "profiler/profiler.hpp"
 #include "scene.hpp"
+#include "shaderPrograms.hpp"
 #include "window.hpp"
 
 int main()
@@ -11,12 +13,15 @@ int main()
 
 	while (!window.shouldClose())
 	{
+		Profiler::beginFrame();
+		ShaderPrograms::update();
 		gui.update();
 		scene.update();
 		scene.render();
 		gui.render();
 		window.swapBuffers();
 		window.pollEvents();
+		Profiler::endFrame();
 	}
 
 	return 0;
@@ -0,0 +1,172 @@
+#include "mappedFile.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+MappedFile::MappedFile(const std::string& path)
+{
+	map(path);
+}
+
+MappedFile::MappedFile(MappedFile&& file) noexcept :
+	m_data{file.m_data},
+	m_size{file.m_size},
+#ifdef _WIN32
+	m_fileHandle{file.m_fileHandle},
+	m_mappingHandle{file.m_mappingHandle}
+#else
+	m_fileDescriptor{file.m_fileDescriptor}
+#endif
+{
+	file.m_isValid = false;
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+{
+	unmap();
+
+	m_data = file.m_data;
+	m_size = file.m_size;
+#ifdef _WIN32
+	m_fileHandle = file.m_fileHandle;
+	m_mappingHandle = file.m_mappingHandle;
+#else
+	m_fileDescriptor = file.m_fileDescriptor;
+#endif
+	m_isValid = true;
+
+	file.m_isValid = false;
+
+	return *this;
+}
+
+bool MappedFile::isOpen() const
+{
+#ifdef _WIN32
+	return m_fileHandle != nullptr;
+#else
+	return m_fileDescriptor != -1;
+#endif
+}
+
+std::string_view MappedFile::getContents() const
+{
+	return std::string_view{m_data, m_size};
+}
+
+#ifdef _WIN32
+
+void MappedFile::map(const std::string& path)
+{
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	m_fileHandle = fileHandle;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+	{
+		return;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		return;
+	}
+	m_mappingHandle = mappingHandle;
+
+	void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		return;
+	}
+	m_data = static_cast<const char*>(data);
+	m_size = static_cast<std::size_t>(size.QuadPart);
+}
+
+void MappedFile::unmap() const
+{
+	if (!m_isValid)
+	{
+		return;
+	}
+
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mappingHandle != nullptr)
+	{
+		CloseHandle(m_mappingHandle);
+	}
+	if (m_fileHandle != nullptr)
+	{
+		CloseHandle(m_fileHandle);
+	}
+}
+
+#else
+
+void MappedFile::map(const std::string& path)
+{
+	int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor == -1)
+	{
+		return;
+	}
+	m_fileDescriptor = fileDescriptor;
+
+	struct stat status{};
+	if (fstat(fileDescriptor, &status) != 0 || status.st_size == 0)
+	{
+		return;
+	}
+
+	void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE,
+		fileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		return;
+	}
+	madvise(data, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+	m_data = static_cast<const char*>(data);
+	m_size = static_cast<std::size_t>(status.st_size);
+}
+
+void MappedFile::unmap() const
+{
+	if (!m_isValid)
+	{
+		return;
+	}
+
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<char*>(m_data), m_size);
+	}
+	if (m_fileDescriptor != -1)
+	{
+		close(m_fileDescriptor);
+	}
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+public:
+	MappedFile(const std::string& path);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& file) noexcept;
+	~MappedFile();
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& file) noexcept;
+
+	bool isOpen() const;
+	std::string_view getContents() const;
+
+private:
+	bool m_isValid = true;
+
+	const char* m_data{};
+	std::size_t m_size{};
+#ifdef _WIN32
+	void* m_fileHandle{};
+	void* m_mappingHandle{};
+#else
+	int m_fileDescriptor = -1;
+#endif
+
+	void map(const std::string& path);
+	void unmap() const;
+};
@@ -41,7 +41,7 @@ Mesh& Mesh::operator=(Mesh&& mesh) noexcept
 	return *this;
 }
 
-void Mesh::update(const std::vector<Vertex>& vertices) const
+void Mesh::update(std::span<const Vertex> vertices) const
 {
 	updateVBO(vertices, true);
 }
@@ -57,6 +57,11 @@ void Mesh::render() const
 	glBindVertexArray(0);
 }
 
+void Mesh::bindAsStorageBuffer(unsigned int binding) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_VBO);
+}
+
 void Mesh::createVBO(const std::vector<Vertex>& vertices, bool dynamic)
 {
 	glGenBuffers(1, &m_VBO);
@@ -90,7 +95,7 @@ void Mesh::createVAO()
 	glBindVertexArray(0);
 }
 
-void Mesh::updateVBO(const std::vector<Vertex>& vertices, bool dynamic) const
+void Mesh::updateVBO(std::span<const Vertex> vertices, bool dynamic) const
 {
 	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
 	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)),
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 
 #include <cstddef>
+#include <span>
 #include <vector>
 
 class Mesh
@@ -23,8 +24,9 @@ public:
 	Mesh& operator=(const Mesh&) = delete;
 	Mesh& operator=(Mesh&& mesh) noexcept;
 
-	void update(const std::vector<Vertex>& vertices) const;
+	void update(std::span<const Vertex> vertices) const;
 	void render() const;
+	void bindAsStorageBuffer(unsigned int binding) const;
 
 private:
 	bool m_isValid = true;
@@ -38,7 +40,7 @@ private:
 	void createVBO(const std::vector<Vertex>& vertices, bool dynamic);
 	void createEBO(const std::vector<unsigned int>& indices);
 	void createVAO();
-	void updateVBO(const std::vector<Vertex>& vertices, bool dynamic) const;
+	void updateVBO(std::span<const Vertex> vertices, bool dynamic) const;
 
 	void destroyBuffers() const;
 };
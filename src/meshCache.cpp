@@ -0,0 +1,154 @@
+#include "meshCache.hpp"
+
+#include "mappedFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+std::optional<std::vector<IndexedMesh>> MeshCache::load(const std::string& sourcePath,
+	std::size_t requestedLODCount)
+{
+	std::optional<Header> expectedHeader = sourceHeader(sourcePath);
+	if (!expectedHeader)
+	{
+		return std::nullopt;
+	}
+
+	MappedFile file{cachePath(sourcePath)};
+	std::string_view contents = file.getContents();
+	if (contents.size() < sizeof(Header))
+	{
+		return std::nullopt;
+	}
+
+	Header header{};
+	std::memcpy(&header, contents.data(), sizeof(Header));
+	contents.remove_prefix(sizeof(Header));
+	if (header.magic != expectedHeader->magic || header.version != expectedHeader->version ||
+		header.sourceSize != expectedHeader->sourceSize ||
+		header.sourceTime != expectedHeader->sourceTime ||
+		header.requestedLODCount != requestedLODCount || header.lodCount == 0)
+	{
+		return std::nullopt;
+	}
+
+	std::vector<IndexedMesh> lods{};
+	for (std::uint32_t i = 0; i < header.lodCount; ++i)
+	{
+		std::optional<IndexedMesh> lod = loadLOD(contents);
+		if (!lod)
+		{
+			return std::nullopt;
+		}
+		lods.push_back(std::move(*lod));
+	}
+	if (!contents.empty())
+	{
+		return std::nullopt;
+	}
+
+	return lods;
+}
+
+void MeshCache::save(const std::string& sourcePath, std::size_t requestedLODCount,
+	const std::vector<IndexedMesh>& lods)
+{
+	std::optional<Header> header = sourceHeader(sourcePath);
+	if (!header)
+	{
+		return;
+	}
+	header->requestedLODCount = static_cast<std::uint32_t>(requestedLODCount);
+	header->lodCount = static_cast<std::uint32_t>(lods.size());
+
+	std::string path = cachePath(sourcePath);
+	std::ofstream file{path, std::ios::binary | std::ios::trunc};
+	if (!file)
+	{
+		std::cerr << "Error writing mesh cache:\n" << path << '\n';
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&*header), sizeof(Header));
+	for (const IndexedMesh& lod : lods)
+	{
+		LODHeader lodHeader{};
+		lodHeader.vertexCount = static_cast<std::uint32_t>(lod.vertices.size());
+		lodHeader.indexCount = static_cast<std::uint32_t>(lod.indices.size());
+		lodHeader.texCoordCount = static_cast<std::uint32_t>(lod.texCoords.size());
+
+		file.write(reinterpret_cast<const char*>(&lodHeader), sizeof(LODHeader));
+		file.write(reinterpret_cast<const char*>(lod.vertices.data()),
+			static_cast<std::streamsize>(lod.vertices.size() * sizeof(Mesh::Vertex)));
+		file.write(reinterpret_cast<const char*>(lod.indices.data()),
+			static_cast<std::streamsize>(lod.indices.size() * sizeof(unsigned int)));
+		file.write(reinterpret_cast<const char*>(lod.texCoords.data()),
+			static_cast<std::streamsize>(lod.texCoords.size() * sizeof(glm::vec2)));
+	}
+}
+
+std::optional<IndexedMesh> MeshCache::loadLOD(std::string_view& contents)
+{
+	if (contents.size() < sizeof(LODHeader))
+	{
+		return std::nullopt;
+	}
+
+	LODHeader header{};
+	std::memcpy(&header, contents.data(), sizeof(LODHeader));
+	contents.remove_prefix(sizeof(LODHeader));
+
+	std::size_t verticesSize = header.vertexCount * sizeof(Mesh::Vertex);
+	std::size_t indicesSize = header.indexCount * sizeof(unsigned int);
+	std::size_t texCoordsSize = header.texCoordCount * sizeof(glm::vec2);
+	if ((header.texCoordCount != 0 && header.texCoordCount != header.vertexCount) ||
+		contents.size() < verticesSize + indicesSize + texCoordsSize)
+	{
+		return std::nullopt;
+	}
+
+	IndexedMesh mesh{};
+	mesh.vertices.resize(header.vertexCount);
+	mesh.indices.resize(header.indexCount);
+	mesh.texCoords.resize(header.texCoordCount);
+	std::memcpy(mesh.vertices.data(), contents.data(), verticesSize);
+	std::memcpy(mesh.indices.data(), contents.data() + verticesSize, indicesSize);
+	std::memcpy(mesh.texCoords.data(), contents.data() + verticesSize + indicesSize,
+		texCoordsSize);
+	contents.remove_prefix(verticesSize + indicesSize + texCoordsSize);
+
+	return mesh;
+}
+
+std::string MeshCache::cachePath(const std::string& sourcePath)
+{
+	return sourcePath + ".cache";
+}
+
+std::optional<MeshCache::Header> MeshCache::sourceHeader(const std::string& sourcePath)
+{
+	std::error_code error{};
+	std::uintmax_t size = std::filesystem::file_size(sourcePath, error);
+	if (error)
+	{
+		return std::nullopt;
+	}
+	std::filesystem::file_time_type time = std::filesystem::last_write_time(sourcePath, error);
+	if (error)
+	{
+		return std::nullopt;
+	}
+
+	Header header{};
+	header.magic = magic;
+	header.version = version;
+	header.sourceSize = static_cast<std::uint64_t>(size);
+	header.sourceTime = static_cast<std::int64_t>(time.time_since_epoch().count());
+	return header;
+}
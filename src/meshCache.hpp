@@ -0,0 +1,47 @@
+#pragma once
+
+#include "indexedMesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MeshCache
+{
+public:
+	MeshCache() = delete;
+	static std::optional<std::vector<IndexedMesh>> load(const std::string& sourcePath,
+		std::size_t requestedLODCount);
+	static void save(const std::string& sourcePath, std::size_t requestedLODCount,
+		const std::vector<IndexedMesh>& lods);
+	~MeshCache() = delete;
+
+private:
+	static constexpr std::uint32_t magic = 0x4d534245; // "EBSM"
+	static constexpr std::uint32_t version = 3;
+
+	struct Header
+	{
+		std::uint32_t magic{};
+		std::uint32_t version{};
+		std::uint64_t sourceSize{};
+		std::int64_t sourceTime{};
+		std::uint32_t requestedLODCount{};
+		std::uint32_t lodCount{};
+	};
+
+	struct LODHeader
+	{
+		std::uint32_t vertexCount{};
+		std::uint32_t indexCount{};
+		std::uint32_t texCoordCount{};
+		std::uint32_t padding{};
+	};
+
+	static std::optional<IndexedMesh> loadLOD(std::string_view& contents);
+	static std::string cachePath(const std::string& sourcePath);
+	static std::optional<Header> sourceHeader(const std::string& sourcePath);
+};
@@ -0,0 +1,28 @@
+#include "meshLoader.hpp"
+
+#include "meshCache.hpp"
+#include "meshSimplifier.hpp"
+#include "objParser.hpp"
+
+#include <optional>
+#include <utility>
+
+std::vector<IndexedMesh> MeshLoader::loadLODs(const std::string& path, std::size_t lodCount)
+{
+	std::optional<std::vector<IndexedMesh>> cachedLODs = MeshCache::load(path, lodCount);
+	if (cachedLODs)
+	{
+		return std::move(*cachedLODs);
+	}
+
+	std::optional<IndexedMesh> mesh = ObjParser::parse(path);
+	if (!mesh)
+	{
+		return std::vector<IndexedMesh>{};
+	}
+
+	std::vector<IndexedMesh> lods = MeshSimplifier::createLODs(std::move(*mesh), lodCount,
+		lodTriangleRatio, minLODTriangleCount);
+	MeshCache::save(path, lodCount, lods);
+	return lods;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "indexedMesh.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class MeshLoader
+{
+public:
+	MeshLoader() = delete;
+	// Returns the parsed mesh followed by progressively simplified levels of detail, using the
+	// binary mesh cache next to the source file when it is up to date.
+	static std::vector<IndexedMesh> loadLODs(const std::string& path, std::size_t lodCount);
+	~MeshLoader() = delete;
+
+private:
+	static constexpr float lodTriangleRatio = 0.25f;
+	static constexpr std::size_t minLODTriangleCount = 64;
+};
@@ -0,0 +1,412 @@
+#include "meshSimplifier.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+IndexedMesh MeshSimplifier::simplify(const IndexedMesh& mesh, std::size_t targetTriangleCount)
+{
+	// Edge collapses are performed on positions welded across attribute seams so that the
+	// simplification cannot tear the surface apart. Vertices which shared a position before are
+	// told apart by their seam slot, so seams survive while collapsed vertices are merged.
+	std::vector<glm::dvec3> poss{};
+	std::vector<unsigned int> vertexSeamSlots{};
+	std::vector<unsigned int> vertexPoss = weldPoss(mesh, poss, vertexSeamSlots);
+
+	std::size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<std::array<unsigned int, 3>> triangles(triangleCount);
+	std::vector<bool> isTriangleRemoved(triangleCount, false);
+	std::vector<std::vector<unsigned int>> posTriangles(poss.size());
+	std::vector<Quadric> quadrics(poss.size());
+	std::size_t liveTriangleCount = 0;
+
+	for (std::size_t i = 0; i < triangleCount; ++i)
+	{
+		std::array<unsigned int, 3>& triangle = triangles[i];
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			triangle[j] = vertexPoss[mesh.indices[3 * i + j]];
+		}
+
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+			triangle[2] == triangle[0])
+		{
+			isTriangleRemoved[i] = true;
+			continue;
+		}
+		++liveTriangleCount;
+
+		glm::dvec3 normalVector = glm::cross(poss[triangle[1]] - poss[triangle[0]],
+			poss[triangle[2]] - poss[triangle[0]]);
+		double doubleArea = glm::length(normalVector);
+		if (doubleArea > 0)
+		{
+			normalVector /= doubleArea;
+		}
+		double distance = -glm::dot(normalVector, poss[triangle[0]]);
+
+		for (unsigned int pos : triangle)
+		{
+			quadrics[pos].addPlane(normalVector, distance, doubleArea / 2);
+			posTriangles[pos].push_back(static_cast<unsigned int>(i));
+		}
+	}
+	addBoundaryQuadrics(triangles, poss, quadrics);
+
+	std::vector<unsigned int> versions(poss.size(), 0);
+	std::vector<bool> isPosRemoved(poss.size(), false);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses{};
+	for (std::size_t i = 0; i < triangleCount; ++i)
+	{
+		if (isTriangleRemoved[i])
+		{
+			continue;
+		}
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			unsigned int pos0 = triangles[i][j];
+			unsigned int pos1 = triangles[i][(j + 1) % 3];
+			if (pos0 < pos1)
+			{
+				collapses.push(createCollapse(pos0, pos1, poss, quadrics, versions));
+			}
+		}
+	}
+
+	std::vector<unsigned int> neighbors{};
+	while (liveTriangleCount > targetTriangleCount && !collapses.empty())
+	{
+		Collapse collapse = collapses.top();
+		collapses.pop();
+
+		unsigned int pos0 = collapse.pos0;
+		unsigned int pos1 = collapse.pos1;
+		if (isPosRemoved[pos0] || isPosRemoved[pos1] || versions[pos0] != collapse.version0 ||
+			versions[pos1] != collapse.version1)
+		{
+			continue;
+		}
+
+		bool flips = false;
+		for (unsigned int pos : {pos0, pos1})
+		{
+			for (unsigned int triangle : posTriangles[pos])
+			{
+				const std::array<unsigned int, 3>& corners = triangles[triangle];
+				bool isCollapsed = std::find(corners.begin(), corners.end(), pos0) !=
+					corners.end() && std::find(corners.begin(), corners.end(), pos1) !=
+					corners.end();
+				if (!isTriangleRemoved[triangle] && !isCollapsed &&
+					flipsTriangle(corners, pos, collapse.target, poss))
+				{
+					flips = true;
+				}
+			}
+		}
+		if (flips)
+		{
+			continue;
+		}
+
+		poss[pos0] = collapse.target;
+		quadrics[pos0] += quadrics[pos1];
+		isPosRemoved[pos1] = true;
+		++versions[pos0];
+
+		for (unsigned int triangle : posTriangles[pos1])
+		{
+			if (isTriangleRemoved[triangle])
+			{
+				continue;
+			}
+
+			std::array<unsigned int, 3>& corners = triangles[triangle];
+			if (std::find(corners.begin(), corners.end(), pos0) != corners.end())
+			{
+				isTriangleRemoved[triangle] = true;
+				--liveTriangleCount;
+			}
+			else
+			{
+				std::replace(corners.begin(), corners.end(), pos1, pos0);
+				posTriangles[pos0].push_back(triangle);
+			}
+		}
+		posTriangles[pos1].clear();
+		posTriangles[pos0].erase(std::remove_if(posTriangles[pos0].begin(),
+			posTriangles[pos0].end(),
+			[&isTriangleRemoved] (unsigned int triangle) { return isTriangleRemoved[triangle]; }),
+			posTriangles[pos0].end());
+
+		neighbors.clear();
+		for (unsigned int triangle : posTriangles[pos0])
+		{
+			for (unsigned int pos : triangles[triangle])
+			{
+				if (pos != pos0)
+				{
+					neighbors.push_back(pos);
+				}
+			}
+		}
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		for (unsigned int neighbor : neighbors)
+		{
+			collapses.push(createCollapse(pos0, neighbor, poss, quadrics, versions));
+		}
+	}
+
+	std::unordered_map<std::uint64_t, unsigned int> newVertexIndices{};
+	IndexedMesh simplifiedMesh{};
+	simplifiedMesh.indices.reserve(3 * liveTriangleCount);
+	for (std::size_t i = 0; i < triangleCount; ++i)
+	{
+		if (isTriangleRemoved[i])
+		{
+			continue;
+		}
+
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			unsigned int vertexIndex = mesh.indices[3 * i + j];
+			std::uint64_t key = (static_cast<std::uint64_t>(triangles[i][j]) << 32) |
+				vertexSeamSlots[vertexIndex];
+
+			auto [newVertexIndex, isInserted] = newVertexIndices.try_emplace(key,
+				static_cast<unsigned int>(simplifiedMesh.vertices.size()));
+			if (isInserted)
+			{
+				Mesh::Vertex vertex = mesh.vertices[vertexIndex];
+				vertex.pos = glm::vec3{poss[triangles[i][j]]};
+				simplifiedMesh.vertices.push_back(vertex);
+				if (!mesh.texCoords.empty())
+				{
+					simplifiedMesh.texCoords.push_back(mesh.texCoords[vertexIndex]);
+				}
+			}
+			simplifiedMesh.indices.push_back(newVertexIndex->second);
+		}
+	}
+
+	return simplifiedMesh;
+}
+
+std::vector<IndexedMesh> MeshSimplifier::createLODs(IndexedMesh mesh, std::size_t lodCount,
+	float triangleRatio, std::size_t minTriangleCount)
+{
+	std::vector<IndexedMesh> lods{};
+	lods.push_back(std::move(mesh));
+
+	while (lods.size() < lodCount)
+	{
+		std::size_t triangleCount = lods.back().indices.size() / 3;
+		std::size_t targetTriangleCount =
+			static_cast<std::size_t>(static_cast<float>(triangleCount) * triangleRatio);
+		if (targetTriangleCount < minTriangleCount)
+		{
+			break;
+		}
+
+		IndexedMesh lod = simplify(lods.back(), targetTriangleCount);
+		if (lod.indices.size() >= lods.back().indices.size())
+		{
+			break;
+		}
+		lods.push_back(std::move(lod));
+	}
+
+	return lods;
+}
+
+void MeshSimplifier::Quadric::addPlane(const glm::dvec3& normalVector, double distance,
+	double weight)
+{
+	const double a = normalVector.x;
+	const double b = normalVector.y;
+	const double c = normalVector.z;
+	const double d = distance;
+
+	m_coefficients[0] += weight * a * a;
+	m_coefficients[1] += weight * a * b;
+	m_coefficients[2] += weight * a * c;
+	m_coefficients[3] += weight * a * d;
+	m_coefficients[4] += weight * b * b;
+	m_coefficients[5] += weight * b * c;
+	m_coefficients[6] += weight * b * d;
+	m_coefficients[7] += weight * c * c;
+	m_coefficients[8] += weight * c * d;
+	m_coefficients[9] += weight * d * d;
+}
+
+double MeshSimplifier::Quadric::error(const glm::dvec3& pos) const
+{
+	const std::array<double, 10>& q = m_coefficients;
+	const double x = pos.x;
+	const double y = pos.y;
+	const double z = pos.z;
+
+	return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x +
+		q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y +
+		q[7] * z * z + 2 * q[8] * z +
+		q[9];
+}
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(const Quadric& quadric)
+{
+	for (std::size_t i = 0; i < m_coefficients.size(); ++i)
+	{
+		m_coefficients[i] += quadric.m_coefficients[i];
+	}
+	return *this;
+}
+
+bool MeshSimplifier::Collapse::operator>(const Collapse& collapse) const
+{
+	return error > collapse.error;
+}
+
+std::vector<unsigned int> MeshSimplifier::weldPoss(const IndexedMesh& mesh,
+	std::vector<glm::dvec3>& poss, std::vector<unsigned int>& vertexSeamSlots)
+{
+	std::vector<unsigned int> order(mesh.vertices.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = static_cast<unsigned int>(i);
+	}
+
+	auto posKey =
+		[&mesh] (unsigned int vertex)
+		{
+			const glm::vec3& pos = mesh.vertices[vertex].pos;
+			return std::make_tuple(pos.x, pos.y, pos.z);
+		};
+	std::sort(order.begin(), order.end(),
+		[&posKey] (unsigned int left, unsigned int right) { return posKey(left) < posKey(right); }
+	);
+
+	std::vector<unsigned int> vertexPoss(mesh.vertices.size());
+	vertexSeamSlots.resize(mesh.vertices.size());
+	unsigned int seamSlot = 0;
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		if (i == 0 || posKey(order[i]) != posKey(order[i - 1]))
+		{
+			poss.push_back(glm::dvec3{mesh.vertices[order[i]].pos});
+			seamSlot = 0;
+		}
+		vertexPoss[order[i]] = static_cast<unsigned int>(poss.size() - 1);
+		vertexSeamSlots[order[i]] = seamSlot++;
+	}
+	return vertexPoss;
+}
+
+void MeshSimplifier::addBoundaryQuadrics(
+	const std::vector<std::array<unsigned int, 3>>& triangles,
+	const std::vector<glm::dvec3>& poss, std::vector<Quadric>& quadrics)
+{
+	// An edge used by only one triangle lies on the boundary. A plane through it, perpendicular
+	// to the triangle, keeps collapses from pulling the boundary inwards.
+	std::vector<std::tuple<unsigned int, unsigned int, unsigned int>> edges{};
+	for (std::size_t i = 0; i < triangles.size(); ++i)
+	{
+		const std::array<unsigned int, 3>& triangle = triangles[i];
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+			triangle[2] == triangle[0])
+		{
+			continue;
+		}
+
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			unsigned int pos0 = triangle[j];
+			unsigned int pos1 = triangle[(j + 1) % 3];
+			edges.emplace_back(std::min(pos0, pos1), std::max(pos0, pos1),
+				static_cast<unsigned int>(i));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+
+	for (std::size_t i = 0; i < edges.size(); ++i)
+	{
+		auto [pos0, pos1, triangle] = edges[i];
+		bool isShared = (i > 0 && std::get<0>(edges[i - 1]) == pos0 &&
+			std::get<1>(edges[i - 1]) == pos1) || (i + 1 < edges.size() &&
+			std::get<0>(edges[i + 1]) == pos0 && std::get<1>(edges[i + 1]) == pos1);
+		if (isShared)
+		{
+			continue;
+		}
+
+		const std::array<unsigned int, 3>& corners = triangles[triangle];
+		glm::dvec3 faceNormalVector = glm::cross(poss[corners[1]] - poss[corners[0]],
+			poss[corners[2]] - poss[corners[0]]);
+		glm::dvec3 edge = poss[pos1] - poss[pos0];
+		glm::dvec3 normalVector = glm::cross(edge, faceNormalVector);
+		double length = glm::length(normalVector);
+		if (length == 0)
+		{
+			continue;
+		}
+		normalVector /= length;
+
+		double distance = -glm::dot(normalVector, poss[pos0]);
+		double weight = boundaryWeight * glm::dot(edge, edge);
+		quadrics[pos0].addPlane(normalVector, distance, weight);
+		quadrics[pos1].addPlane(normalVector, distance, weight);
+	}
+}
+
+MeshSimplifier::Collapse MeshSimplifier::createCollapse(unsigned int pos0, unsigned int pos1,
+	const std::vector<glm::dvec3>& poss, const std::vector<Quadric>& quadrics,
+	const std::vector<unsigned int>& versions)
+{
+	Quadric quadric = quadrics[pos0];
+	quadric += quadrics[pos1];
+
+	Collapse collapse{};
+	collapse.pos0 = pos0;
+	collapse.pos1 = pos1;
+	collapse.version0 = versions[pos0];
+	collapse.version1 = versions[pos1];
+	collapse.target = poss[pos0];
+	collapse.error = quadric.error(poss[pos0]);
+
+	for (const glm::dvec3& target : {poss[pos1], (poss[pos0] + poss[pos1]) / 2.0})
+	{
+		double error = quadric.error(target);
+		if (error < collapse.error)
+		{
+			collapse.error = error;
+			collapse.target = target;
+		}
+	}
+
+	return collapse;
+}
+
+bool MeshSimplifier::flipsTriangle(const std::array<unsigned int, 3>& triangle,
+	unsigned int movedPos, const glm::dvec3& target, const std::vector<glm::dvec3>& poss)
+{
+	std::array<glm::dvec3, 3> corners{};
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		corners[i] = triangle[i] == movedPos ? target : poss[triangle[i]];
+	}
+
+	glm::dvec3 oldNormalVector = glm::cross(poss[triangle[1]] - poss[triangle[0]],
+		poss[triangle[2]] - poss[triangle[0]]);
+	glm::dvec3 newNormalVector = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+	double oldLength = glm::length(oldNormalVector);
+	double newLength = glm::length(newNormalVector);
+	if (oldLength == 0 || newLength == 0)
+	{
+		return newLength == 0;
+	}
+
+	return glm::dot(oldNormalVector, newNormalVector) < minFlipCos * oldLength * newLength;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "indexedMesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class MeshSimplifier
+{
+public:
+	MeshSimplifier() = delete;
+	static IndexedMesh simplify(const IndexedMesh& mesh, std::size_t targetTriangleCount);
+	static std::vector<IndexedMesh> createLODs(IndexedMesh mesh, std::size_t lodCount,
+		float triangleRatio, std::size_t minTriangleCount);
+	~MeshSimplifier() = delete;
+
+private:
+	static constexpr double boundaryWeight = 100.0;
+	static constexpr double minFlipCos = 0.2;
+
+	class Quadric
+	{
+	public:
+		void addPlane(const glm::dvec3& normalVector, double distance, double weight);
+		double error(const glm::dvec3& pos) const;
+		Quadric& operator+=(const Quadric& quadric);
+
+	private:
+		// Upper triangle of the symmetric 4x4 matrix: a2 ab ac ad b2 bc bd c2 cd d2.
+		std::array<double, 10> m_coefficients{};
+	};
+
+	struct Collapse
+	{
+		double error{};
+		unsigned int pos0{};
+		unsigned int pos1{};
+		unsigned int version0{};
+		unsigned int version1{};
+		glm::dvec3 target{};
+
+		bool operator>(const Collapse& collapse) const;
+	};
+
+	static std::vector<unsigned int> weldPoss(const IndexedMesh& mesh,
+		std::vector<glm::dvec3>& poss, std::vector<unsigned int>& vertexSeamSlots);
+	static void addBoundaryQuadrics(const std::vector<std::array<unsigned int, 3>>& triangles,
+		const std::vector<glm::dvec3>& poss, std::vector<Quadric>& quadrics);
+	static Collapse createCollapse(unsigned int pos0, unsigned int pos1,
+		const std::vector<glm::dvec3>& poss, const std::vector<Quadric>& quadrics,
+		const std::vector<unsigned int>& versions);
+	static bool flipsTriangle(const std::array<unsigned int, 3>& triangle, unsigned int movedPos,
+		const glm::dvec3& target, const std::vector<glm::dvec3>& poss);
+};
@@ -10,13 +10,18 @@ Model::Model(Mesh mesh, const ShaderProgram& shaderProgram, const glm::vec4& col
 	m_depthOffset{depthOffset}
 { }
 
-void Model::updateMesh(const std::vector<Mesh::Vertex>& vertices)
+void Model::updateMesh(std::span<const Mesh::Vertex> vertices)
 {
 	m_mesh.update(vertices);
 }
 
 void Model::render() const
 {
+	if (!m_shaderProgram.isReady())
+	{
+		return;
+	}
+
 	m_shaderProgram.use();
 	m_shaderProgram.setUniform("modelMatrix", getMatrix());
 	m_shaderProgram.setUniform("color", m_color);
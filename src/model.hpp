@@ -7,6 +7,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <span>
+
 class Model : public Frame
 {
 public:
@@ -14,7 +16,7 @@ public:
 		bool depthOffset = false);
 	virtual ~Model() = default;
 
-	void updateMesh(const std::vector<Mesh::Vertex>& vertices);
+	void updateMesh(std::span<const Mesh::Vertex> vertices);
 	void render() const;
 
 	const Mesh& getMesh() const;
@@ -1,140 +1,511 @@
 #include "objParser.hpp"
 
-#include <glm/glm.hpp>
+#include "arena.hpp"
+#include "mappedFile.hpp"
+#include "parallel.hpp"
 
-#include <cstddef>
-#include <fstream>
+#include <algorithm>
+#include <charconv>
 #include <iostream>
+#include <limits>
+#include <utility>
 
-std::vector<Mesh::Vertex> ObjParser::parse(const std::string& path)
+std::optional<IndexedMesh> ObjParser::parse(const std::string& path)
 {
-	std::ifstream file{path};
-	if (!file)
+	MappedFile file{path};
+	if (!file.isOpen())
 	{
 		std::cerr << "File does not exist:\n" << path << '\n';
-		assert(false);
-		return std::vector<Mesh::Vertex>{};
+		return std::nullopt;
 	}
 
-	std::vector<Mesh::Vertex> vertices{};
+	std::vector<std::string_view> chunkTexts = splitIntoChunks(file.getContents());
+	std::vector<Chunk> chunks(chunkTexts.size());
+	Parallel::forRange(chunkTexts.size(), 1,
+		[&chunkTexts, &chunks] (std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				chunks[i] = parseChunk(chunkTexts[i]);
+			}
+		}
+	);
+
+	std::size_t lineBase = 0;
+	for (const Chunk& chunk : chunks)
+	{
+		if (chunk.invalidLine.has_value())
+		{
+			std::cerr << "Error parsing OBJ file, invalid vertex data at line " <<
+				lineBase + *chunk.invalidLine << ":\n" << path << '\n';
+			return std::nullopt;
+		}
+		lineBase += chunk.lineCount;
+	}
 
-	std::vector<glm::vec3> poss{};
-	std::vector<glm::vec3> normalVectors{};
+	// Merge buffers are released together once the mesh is built, sized after the file since
+	// they grow with it.
+	Arena scratch{file.getContents().size()};
+	std::size_t invalidFaceCount = 0;
+	IndexedMesh mesh = mergeChunks(chunks, invalidFaceCount, &scratch);
+	if (invalidFaceCount > 0)
+	{
+		std::cerr << "Skipped " << invalidFaceCount << " invalid faces in OBJ file:\n" << path <<
+			'\n';
+	}
+	if (mesh.indices.empty())
+	{
+		std::cerr << "Error parsing OBJ file, no valid faces:\n" << path << '\n';
+		return std::nullopt;
+	}
 
-	std::string line{};
-	while (std::getline(file, line))
+	return mesh;
+}
+
+std::vector<std::string_view> ObjParser::splitIntoChunks(std::string_view contents)
+{
+	std::size_t chunkCount = std::max<std::size_t>(
+		std::min(contents.size() / minChunkSize, Parallel::threadCount()), 1);
+	std::size_t chunkSize = contents.size() / chunkCount;
+
+	std::vector<std::string_view> chunks{};
+	std::size_t begin = 0;
+	for (std::size_t i = 0; i < chunkCount && begin < contents.size(); ++i)
 	{
-		if (line[0] == 'v' && line[1] == ' ')
+		std::size_t end = contents.size();
+		if (i + 1 < chunkCount)
 		{
-			poss.push_back(parsePos(line));
+			end = contents.find('\n', std::max(begin, (i + 1) * chunkSize));
+			end = end == std::string_view::npos ? contents.size() : end + 1;
 		}
-		else if (line[0] == 'v' && line[1] == 'n' && line[2] == ' ')
+		chunks.push_back(contents.substr(begin, end - begin));
+		begin = end;
+	}
+	return chunks;
+}
+
+ObjParser::Chunk ObjParser::parseChunk(std::string_view text)
+{
+	Chunk chunk{};
+	std::vector<FaceVertex> polygon{};
+	while (!text.empty())
+	{
+		std::string_view line = nextLine(text);
+		++chunk.lineCount;
+		skipWhitespace(line);
+		std::size_t keywordEnd = std::min(line.find_first_of(" \t"), line.size());
+		std::string_view keyword = line.substr(0, keywordEnd);
+		line.remove_prefix(keywordEnd);
+
+		bool isValid = true;
+		if (keyword == "v")
 		{
-			normalVectors.push_back(parseNormalVector(line));
+			isValid = parseVec3(line, chunk.poss.emplace_back());
 		}
-		else if (line[0] == 'f' && line[1] == ' ')
+		else if (keyword == "vt")
 		{
-			std::array<Mesh::Vertex, 3> triangle = parseTriangle(line, poss, normalVectors);
-			vertices.push_back(triangle[0]);
-			vertices.push_back(triangle[1]);
-			vertices.push_back(triangle[2]);
+			isValid = parseVec2(line, chunk.texCoords.emplace_back());
+		}
+		else if (keyword == "vn")
+		{
+			isValid = parseVec3(line, chunk.normalVectors.emplace_back());
+		}
+		else if (keyword == "f")
+		{
+			if (!parseFace(line, chunk, polygon))
+			{
+				++chunk.invalidFaceCount;
+				continue;
+			}
+
+			for (std::size_t i = 1; i + 1 < polygon.size(); ++i)
+			{
+				chunk.faceVertices.push_back(polygon[0]);
+				chunk.faceVertices.push_back(polygon[i]);
+				chunk.faceVertices.push_back(polygon[i + 1]);
+			}
 		}
-	}
 
-	return vertices;
+		if (!isValid)
+		{
+			chunk.invalidLine = chunk.lineCount;
+			break;
+		}
+	}
+	return chunk;
 }
 
-glm::vec3 ObjParser::parsePos(const std::string_view line)
+IndexedMesh ObjParser::mergeChunks(const std::vector<Chunk>& chunks,
+	std::size_t& invalidFaceCount, std::pmr::memory_resource* scratch)
 {
-	glm::vec3 pos{};
+	std::size_t posCount = 0;
+	std::size_t texCoordCount = 0;
+	std::size_t normalVectorCount = 0;
+	std::size_t faceVertexCount = 0;
+	for (const Chunk& chunk : chunks)
+	{
+		posCount += chunk.poss.size();
+		texCoordCount += chunk.texCoords.size();
+		normalVectorCount += chunk.normalVectors.size();
+		faceVertexCount += chunk.faceVertices.size();
+		invalidFaceCount += chunk.invalidFaceCount;
+	}
 
-	int component = 0;
-	std::string number = "";
-	for (auto c = line.begin() + 2; c != line.end(); ++c)
+	std::pmr::vector<glm::vec3> poss(scratch);
+	std::pmr::vector<glm::vec2> texCoords(scratch);
+	std::pmr::vector<glm::vec3> normalVectors(scratch);
+	poss.reserve(posCount);
+	texCoords.reserve(texCoordCount);
+	normalVectors.reserve(normalVectorCount);
+	for (const Chunk& chunk : chunks)
 	{
-		if (*c == ' ')
-		{
-			pos[component] = std::stof(number);
-			++component;
-			number = "";
-		}
-		else
+		poss.insert(poss.end(), chunk.poss.begin(), chunk.poss.end());
+		texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+		normalVectors.insert(normalVectors.end(), chunk.normalVectors.begin(),
+			chunk.normalVectors.end());
+	}
+
+	// Vertices sharing a position are chained so that deduplication only compares the few
+	// attribute combinations used with that position instead of hashing every face vertex.
+	static constexpr unsigned int noVertex = std::numeric_limits<unsigned int>::max();
+	std::pmr::vector<unsigned int> firstVertexOfPos(posCount, noVertex, scratch);
+	std::pmr::vector<unsigned int> nextVertexOfPos(scratch);
+	std::pmr::vector<unsigned int> vertexPosIndices(scratch);
+	std::pmr::vector<int> vertexTexCoordIndices(scratch);
+	std::pmr::vector<int> vertexNormalVectorIndices(scratch);
+	std::pmr::vector<bool> vertexNeedsNormalVector(scratch);
+	// Every face vertex adds at most one vertex. Reserved up front since the scratch arena does
+	// not reuse the buffers a growing vector leaves behind.
+	nextVertexOfPos.reserve(faceVertexCount);
+	vertexPosIndices.reserve(faceVertexCount);
+	vertexTexCoordIndices.reserve(faceVertexCount);
+	vertexNormalVectorIndices.reserve(faceVertexCount);
+	vertexNeedsNormalVector.reserve(faceVertexCount);
+	bool hasMissingNormalVectors = false;
+	bool hasTexCoords = texCoordCount > 0;
+
+	IndexedMesh mesh{};
+	mesh.indices.reserve(faceVertexCount);
+
+	std::size_t posBase = 0;
+	std::size_t texCoordBase = 0;
+	std::size_t normalVectorBase = 0;
+	for (const Chunk& chunk : chunks)
+	{
+		for (std::size_t i = 0; i + 2 < chunk.faceVertices.size(); i += 3)
 		{
-			number.push_back(*c);
+			FaceVertex triangle[3]{};
+			bool isValid = true;
+			for (std::size_t j = 0; j < 3; ++j)
+			{
+				const FaceVertex& faceVertex = chunk.faceVertices[i + j];
+				triangle[j] = faceVertex;
+				isValid = isValid &&
+					resolveIndex(faceVertex.posIndex, faceVertex.relativeMask & relativePos,
+						posBase, posCount, triangle[j].posIndex) &&
+					resolveIndex(faceVertex.texCoordIndex,
+						faceVertex.relativeMask & relativeTexCoord, texCoordBase, texCoordCount,
+						triangle[j].texCoordIndex) &&
+					resolveIndex(faceVertex.normalVectorIndex,
+						faceVertex.relativeMask & relativeNormalVector, normalVectorBase,
+						normalVectorCount, triangle[j].normalVectorIndex);
+			}
+			if (!isValid)
+			{
+				++invalidFaceCount;
+				continue;
+			}
+
+			for (const FaceVertex& faceVertex : triangle)
+			{
+				std::size_t posIndex = static_cast<std::size_t>(faceVertex.posIndex);
+
+				unsigned int vertexIndex = firstVertexOfPos[posIndex];
+				while (vertexIndex != noVertex &&
+					(vertexTexCoordIndices[vertexIndex] != faceVertex.texCoordIndex ||
+					vertexNormalVectorIndices[vertexIndex] != faceVertex.normalVectorIndex))
+				{
+					vertexIndex = nextVertexOfPos[vertexIndex];
+				}
+
+				if (vertexIndex == noVertex)
+				{
+					vertexIndex = static_cast<unsigned int>(mesh.vertices.size());
+
+					Mesh::Vertex vertex{};
+					vertex.pos = poss[posIndex];
+					if (faceVertex.normalVectorIndex != noIndex)
+					{
+						vertex.normalVector = normalVectors[faceVertex.normalVectorIndex];
+					}
+					mesh.vertices.push_back(vertex);
+
+					if (hasTexCoords)
+					{
+						mesh.texCoords.push_back(faceVertex.texCoordIndex != noIndex ?
+							texCoords[faceVertex.texCoordIndex] : glm::vec2{});
+					}
+
+					bool needsNormalVector = faceVertex.normalVectorIndex == noIndex;
+					hasMissingNormalVectors = hasMissingNormalVectors || needsNormalVector;
+
+					vertexPosIndices.push_back(static_cast<unsigned int>(posIndex));
+					vertexTexCoordIndices.push_back(faceVertex.texCoordIndex);
+					vertexNormalVectorIndices.push_back(faceVertex.normalVectorIndex);
+					vertexNeedsNormalVector.push_back(needsNormalVector);
+					nextVertexOfPos.push_back(firstVertexOfPos[posIndex]);
+					firstVertexOfPos[posIndex] = vertexIndex;
+				}
+
+				mesh.indices.push_back(vertexIndex);
+			}
 		}
+
+		posBase += chunk.poss.size();
+		texCoordBase += chunk.texCoords.size();
+		normalVectorBase += chunk.normalVectors.size();
 	}
-	pos[component] = std::stof(number);
 
-	return pos;
+	if (hasMissingNormalVectors)
+	{
+		generateNormalVectors(mesh, vertexPosIndices, vertexNeedsNormalVector, scratch);
+	}
+
+	return mesh;
 }
 
-glm::vec3 ObjParser::parseNormalVector(const std::string_view line)
+void ObjParser::generateNormalVectors(IndexedMesh& mesh,
+	std::span<const unsigned int> vertexPosIndices,
+	const std::pmr::vector<bool>& vertexNeedsNormalVector, std::pmr::memory_resource* scratch)
 {
-	glm::vec3 normalVector{};
+	static constexpr std::size_t grainSize = 4096;
 
-	int component = 0;
-	std::string number = "";
-	for (auto c = line.begin() + 3; c != line.end(); ++c)
+	std::size_t triangleCount = mesh.indices.size() / 3;
+	std::size_t posCount = 0;
+	for (unsigned int posIndex : vertexPosIndices)
 	{
-		if (*c == ' ')
+		posCount = std::max<std::size_t>(posCount, posIndex + 1);
+	}
+
+	// Area-weighted face normals are gathered per position so that vertices which only differ
+	// by texture coordinates still get the same smooth normal.
+	std::pmr::vector<glm::vec3> triangleNormalVectors(triangleCount, scratch);
+	Parallel::forRange(triangleCount, grainSize,
+		[&mesh, &triangleNormalVectors] (std::size_t begin, std::size_t end)
 		{
-			normalVector[component] = std::stof(number);
-			++component;
-			number = "";
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const glm::vec3& pos0 = mesh.vertices[mesh.indices[3 * i]].pos;
+				const glm::vec3& pos1 = mesh.vertices[mesh.indices[3 * i + 1]].pos;
+				const glm::vec3& pos2 = mesh.vertices[mesh.indices[3 * i + 2]].pos;
+				triangleNormalVectors[i] = glm::cross(pos1 - pos0, pos2 - pos0);
+			}
 		}
-		else
+	);
+
+	std::pmr::vector<unsigned int> posTriangleOffsets(posCount + 1, 0, scratch);
+	for (unsigned int vertexIndex : mesh.indices)
+	{
+		++posTriangleOffsets[vertexPosIndices[vertexIndex] + 1];
+	}
+	for (std::size_t i = 0; i < posCount; ++i)
+	{
+		posTriangleOffsets[i + 1] += posTriangleOffsets[i];
+	}
+
+	std::pmr::vector<unsigned int> posTriangles(mesh.indices.size(), scratch);
+	std::pmr::vector<unsigned int> posTriangleCounts(posCount, 0, scratch);
+	for (std::size_t i = 0; i < mesh.indices.size(); ++i)
+	{
+		unsigned int posIndex = vertexPosIndices[mesh.indices[i]];
+		posTriangles[posTriangleOffsets[posIndex] + posTriangleCounts[posIndex]++] =
+			static_cast<unsigned int>(i / 3);
+	}
+
+	std::pmr::vector<glm::vec3> posNormalVectors(posCount, scratch);
+	Parallel::forRange(posCount, grainSize,
+		[&posTriangleOffsets, &posTriangles, &triangleNormalVectors, &posNormalVectors]
+		(std::size_t begin, std::size_t end)
 		{
-			number.push_back(*c);
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				glm::vec3 normalVector{};
+				for (unsigned int j = posTriangleOffsets[i]; j < posTriangleOffsets[i + 1]; ++j)
+				{
+					normalVector += triangleNormalVectors[posTriangles[j]];
+				}
+
+				float length = glm::length(normalVector);
+				posNormalVectors[i] = length > 0 ? normalVector / length : glm::vec3{};
+			}
+		}
+	);
+
+	Parallel::forRange(mesh.vertices.size(), grainSize,
+		[&mesh, &vertexPosIndices, &vertexNeedsNormalVector, &posNormalVectors]
+		(std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				if (vertexNeedsNormalVector[i])
+				{
+					mesh.vertices[i].normalVector = posNormalVectors[vertexPosIndices[i]];
+				}
+			}
 		}
+	);
+}
+
+std::string_view ObjParser::nextLine(std::string_view& text)
+{
+	std::size_t end = text.find('\n');
+	std::string_view line = text.substr(0, end);
+	text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+	if (!line.empty() && line.back() == '\r')
+	{
+		line.remove_suffix(1);
 	}
-	normalVector[component] = std::stof(number);
+	return line;
+}
 
-	return normalVector;
+bool ObjParser::parseVec2(std::string_view line, glm::vec2& vector)
+{
+	// The second texture coordinate is optional and defaults to zero.
+	if (!parseFloat(line, vector.x))
+	{
+		return false;
+	}
+	skipWhitespace(line);
+	return line.empty() || line.front() == '#' || parseFloat(line, vector.y);
 }
 
-std::array<Mesh::Vertex, 3> ObjParser::parseTriangle(const std::string_view line,
-	const std::vector<glm::vec3>& poss, const std::vector<glm::vec3>& normalVectors)
+bool ObjParser::parseVec3(std::string_view line, glm::vec3& vector)
 {
-	std::array<Mesh::Vertex, 3> triangle;
+	for (int component = 0; component < 3; ++component)
+	{
+		if (!parseFloat(line, vector[component]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-	std::size_t vertexIndex = 0;
-	std::string number = "";
-	std::size_t posIndex = 0;
-	std::size_t normalVectorIndex = 0;
-	bool isFirstNumber = true;
-	for (auto c = line.begin() + 2; c != line.end(); ++c)
+bool ObjParser::parseFace(std::string_view line, const Chunk& chunk,
+	std::vector<FaceVertex>& polygon)
+{
+	polygon.clear();
+	while (true)
 	{
-		if (*c == ' ')
+		skipWhitespace(line);
+		if (line.empty() || line.front() == '#')
 		{
-			normalVectorIndex = static_cast<std::size_t>(std::stoi(number));
-			number = "";
-			if (vertexIndex < 3)
-			{
-				triangle[vertexIndex].pos = poss[posIndex - 1];
-				triangle[vertexIndex].normalVector = normalVectors[normalVectorIndex - 1];
-			}
-			++vertexIndex;
+			break;
+		}
+
+		FaceVertex faceVertex{};
+		if (!parseIndex(line, chunk.poss.size(), relativePos, faceVertex.posIndex,
+			faceVertex.relativeMask))
+		{
+			return false;
 		}
-		else if (*c == '/')
+		if (!line.empty() && line.front() == '/')
 		{
-			if (isFirstNumber)
+			line.remove_prefix(1);
+			if (!line.empty() && line.front() != '/' &&
+				!parseIndex(line, chunk.texCoords.size(), relativeTexCoord,
+					faceVertex.texCoordIndex, faceVertex.relativeMask))
+			{
+				return false;
+			}
+			if (!line.empty() && line.front() == '/')
 			{
-				posIndex = static_cast<std::size_t>(std::stoi(number));
+				line.remove_prefix(1);
+				if (!parseIndex(line, chunk.normalVectors.size(), relativeNormalVector,
+					faceVertex.normalVectorIndex, faceVertex.relativeMask))
+				{
+					return false;
+				}
 			}
-			number = "";
-			isFirstNumber = !isFirstNumber;
 		}
-		else
+		if (!line.empty() && line.front() != ' ' && line.front() != '\t')
 		{
-			number.push_back(*c);
+			return false;
 		}
+
+		polygon.push_back(faceVertex);
+	}
+
+	return polygon.size() >= 3;
+}
+
+bool ObjParser::parseIndex(std::string_view& text, std::size_t count, std::uint8_t relativeFlag,
+	int& index, std::uint8_t& relativeMask)
+{
+	int value{};
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(),
+		value);
+	if (result.ec != std::errc{} || value == 0)
+	{
+		return false;
+	}
+	text.remove_prefix(static_cast<std::size_t>(result.ptr - text.data()));
+
+	if (value > 0)
+	{
+		index = value - 1;
+	}
+	else
+	{
+		index = static_cast<int>(count) + value;
+		relativeMask |= relativeFlag;
+	}
+	return true;
+}
+
+bool ObjParser::resolveIndex(int index, bool isRelative, std::size_t base, std::size_t count,
+	int& resolvedIndex)
+{
+	if (index == noIndex && !isRelative)
+	{
+		resolvedIndex = noIndex;
+		return true;
 	}
-	normalVectorIndex = static_cast<std::size_t>(std::stoi(number));
-	if (vertexIndex < 3)
+
+	long long absoluteIndex = isRelative ? static_cast<long long>(base) + index : index;
+	if (absoluteIndex < 0 || absoluteIndex >= static_cast<long long>(count))
 	{
-		triangle[vertexIndex].pos = poss[posIndex - 1];
-		triangle[vertexIndex].normalVector = normalVectors[normalVectorIndex - 1];
+		return false;
 	}
 
-	return triangle;
+	resolvedIndex = static_cast<int>(absoluteIndex);
+	return true;
+}
+
+void ObjParser::skipWhitespace(std::string_view& text)
+{
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+	{
+		text.remove_prefix(1);
+	}
+}
+
+bool ObjParser::parseFloat(std::string_view& text, float& value)
+{
+	skipWhitespace(text);
+	if (!text.empty() && text.front() == '+')
+	{
+		text.remove_prefix(1);
+	}
+
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(),
+		value);
+	if (result.ec != std::errc{})
+	{
+		return false;
+	}
+	text.remove_prefix(static_cast<std::size_t>(result.ptr - text.data()));
+	// The number has to make up the whole token.
+	return text.empty() || text.front() == ' ' || text.front() == '\t';
 }
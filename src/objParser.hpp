@@ -1,10 +1,15 @@
 #pragma once
 
+#include "indexedMesh.hpp"
 #include "mesh.hpp"
 
 #include <glm/glm.hpp>
 
-#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -13,12 +18,56 @@ class ObjParser
 {
 public:
 	ObjParser() = delete;
-	static std::vector<Mesh::Vertex> parse(const std::string& path);
+	static std::optional<IndexedMesh> parse(const std::string& path);
 	~ObjParser() = delete;
 
 private:
-	static glm::vec3 parsePos(const std::string_view line);
-	static glm::vec3 parseNormalVector(const std::string_view line);
-	static std::array<Mesh::Vertex, 3> parseTriangle(const std::string_view line,
-		const std::vector<glm::vec3>& pos, const std::vector<glm::vec3>& normalVectors);
+	static constexpr std::size_t minChunkSize = 1 << 16;
+	static constexpr int noIndex = -1;
+
+	// Indices are zero-based. Relative (negative) OBJ indices are stored relative to the
+	// beginning of the chunk and offset by the preceding chunks when the chunks are merged.
+	struct FaceVertex
+	{
+		int posIndex = noIndex;
+		int texCoordIndex = noIndex;
+		int normalVectorIndex = noIndex;
+		std::uint8_t relativeMask{};
+	};
+
+	struct Chunk
+	{
+		std::vector<glm::vec3> poss{};
+		std::vector<glm::vec2> texCoords{};
+		std::vector<glm::vec3> normalVectors{};
+		std::vector<FaceVertex> faceVertices{};
+		std::size_t invalidFaceCount{};
+		// Parsing stops at the first line with malformed vertex data, counted from one.
+		std::size_t lineCount{};
+		std::optional<std::size_t> invalidLine{};
+	};
+
+	static constexpr std::uint8_t relativePos = 1 << 0;
+	static constexpr std::uint8_t relativeTexCoord = 1 << 1;
+	static constexpr std::uint8_t relativeNormalVector = 1 << 2;
+
+	static std::vector<std::string_view> splitIntoChunks(std::string_view contents);
+	static Chunk parseChunk(std::string_view text);
+	static IndexedMesh mergeChunks(const std::vector<Chunk>& chunks, std::size_t& invalidFaceCount,
+		std::pmr::memory_resource* scratch);
+	static void generateNormalVectors(IndexedMesh& mesh,
+		std::span<const unsigned int> vertexPosIndices,
+		const std::pmr::vector<bool>& vertexNeedsNormalVector, std::pmr::memory_resource* scratch);
+
+	static std::string_view nextLine(std::string_view& text);
+	static bool parseVec2(std::string_view line, glm::vec2& vector);
+	static bool parseVec3(std::string_view line, glm::vec3& vector);
+	static bool parseFace(std::string_view line, const Chunk& chunk,
+		std::vector<FaceVertex>& polygon);
+	static bool parseIndex(std::string_view& text, std::size_t count, std::uint8_t relativeFlag,
+		int& index, std::uint8_t& relativeMask);
+	static bool resolveIndex(int index, bool isRelative, std::size_t base, std::size_t count,
+		int& resolvedIndex);
+	static void skipWhitespace(std::string_view& text);
+	static bool parseFloat(std::string_view& text, float& value);
 };
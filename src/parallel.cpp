@@ -0,0 +1,226 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+	class ThreadPool
+	{
+	public:
+		ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		~ThreadPool();
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		std::size_t threadCount() const;
+		void run(std::size_t taskCount, const std::function<void(std::size_t)>& task);
+
+	private:
+		// The tasks of one run call, living on the caller's stack until the workers that joined
+		// it are done.
+		struct TaskGroup
+		{
+			const std::function<void(std::size_t)>* task{};
+			std::size_t taskCount{};
+			std::atomic<std::size_t> nextTask{};
+			std::size_t activeWorkers{};
+		};
+
+		std::vector<std::thread> m_workers{};
+
+		std::mutex m_mutex{};
+		std::condition_variable m_workAvailable{};
+		std::condition_variable m_workDone{};
+
+		std::vector<TaskGroup*> m_groups{};
+		bool m_stop = false;
+
+		void workerLoop();
+		TaskGroup* findGroup() const;
+		static void runTasks(TaskGroup& group);
+	};
+
+	thread_local bool insideParallelRegion = false;
+
+	ThreadPool& threadPool();
+	std::size_t rangeCount(std::size_t count, std::size_t grainSize);
+
+	std::size_t threadCount()
+	{
+		return threadPool().threadCount();
+	}
+
+	void forRange(std::size_t count, std::size_t grainSize,
+		const std::function<void(std::size_t begin, std::size_t end)>& body)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		std::size_t ranges = rangeCount(count, grainSize);
+		if (ranges <= 1 || insideParallelRegion)
+		{
+			body(0, count);
+			return;
+		}
+
+		threadPool().run(ranges,
+			[count, ranges, &body] (std::size_t range)
+			{
+				body(range * count / ranges, (range + 1) * count / ranges);
+			}
+		);
+	}
+
+	float sumRanges(std::size_t count, std::size_t grainSize,
+		const std::function<float(std::size_t begin, std::size_t end)>& body)
+	{
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		std::size_t ranges = rangeCount(count, grainSize);
+		if (ranges <= 1 || insideParallelRegion)
+		{
+			return body(0, count);
+		}
+
+		std::vector<float> partialSums(ranges);
+		threadPool().run(ranges,
+			[count, ranges, &body, &partialSums] (std::size_t range)
+			{
+				partialSums[range] = body(range * count / ranges, (range + 1) * count / ranges);
+			}
+		);
+
+		float sum = 0;
+		for (float partialSum : partialSums)
+		{
+			sum += partialSum;
+		}
+		return sum;
+	}
+
+	std::size_t rangeCount(std::size_t count, std::size_t grainSize)
+	{
+		std::size_t maxRanges = (count + std::max<std::size_t>(grainSize, 1) - 1) /
+			std::max<std::size_t>(grainSize, 1);
+		return std::min(maxRanges, threadCount());
+	}
+
+	ThreadPool& threadPool()
+	{
+		static ThreadPool pool{};
+		return pool;
+	}
+
+	ThreadPool::ThreadPool()
+	{
+		std::size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		for (std::size_t i = 0; i + 1 < hardwareThreads; ++i)
+		{
+			m_workers.emplace_back([this] () { workerLoop(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_stop = true;
+		}
+		m_workAvailable.notify_all();
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	std::size_t ThreadPool::threadCount() const
+	{
+		return m_workers.size() + 1;
+	}
+
+	void ThreadPool::run(std::size_t taskCount, const std::function<void(std::size_t)>& task)
+	{
+		TaskGroup group{};
+		group.task = &task;
+		group.taskCount = taskCount;
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			m_groups.push_back(&group);
+		}
+		m_workAvailable.notify_all();
+
+		runTasks(group);
+
+		// Once removed no worker joins the group anymore, those that did finish their tasks.
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_groups.erase(std::find(m_groups.begin(), m_groups.end(), &group));
+		m_workDone.wait(lock, [&group] () { return group.activeWorkers == 0; });
+	}
+
+	void ThreadPool::workerLoop()
+	{
+		while (true)
+		{
+			TaskGroup* group = nullptr;
+			{
+				std::unique_lock<std::mutex> lock{m_mutex};
+				m_workAvailable.wait(lock,
+					[this, &group] ()
+					{
+						group = findGroup();
+						return m_stop || group != nullptr;
+					}
+				);
+				if (m_stop)
+				{
+					return;
+				}
+				++group->activeWorkers;
+			}
+
+			runTasks(*group);
+
+			std::lock_guard<std::mutex> lock{m_mutex};
+			if (--group->activeWorkers == 0)
+			{
+				m_workDone.notify_all();
+			}
+		}
+	}
+
+	ThreadPool::TaskGroup* ThreadPool::findGroup() const
+	{
+		for (TaskGroup* group : m_groups)
+		{
+			if (group->nextTask < group->taskCount)
+			{
+				return group;
+			}
+		}
+		return nullptr;
+	}
+
+	void ThreadPool::runTasks(TaskGroup& group)
+	{
+		insideParallelRegion = true;
+		for (std::size_t task = group.nextTask++; task < group.taskCount;
+			task = group.nextTask++)
+		{
+			(*group.task)(task);
+		}
+		insideParallelRegion = false;
+	}
+}
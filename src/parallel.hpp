@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace Parallel
+{
+	std::size_t threadCount();
+
+	// Splits [0, count) into contiguous ranges of at least grainSize elements and runs body on
+	// them using a persistent pool of worker threads plus the calling thread. Nested calls run
+	// inline on the calling thread. Calls from several threads share the workers, and each caller
+	// works through its own ranges, so it never waits for the ranges of another call.
+	void forRange(std::size_t count, std::size_t grainSize,
+		const std::function<void(std::size_t begin, std::size_t end)>& body);
+	// Runs body on the ranges forRange would and sums the values it returns for them. The partial
+	// sums are added in range order, so the result does not depend on the scheduling.
+	float sumRanges(std::size_t count, std::size_t grainSize,
+		const std::function<float(std::size_t begin, std::size_t end)>& body);
+}
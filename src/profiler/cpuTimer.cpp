@@ -0,0 +1,19 @@
+#include "profiler/cpuTimer.hpp"
+
+CPUTimer::CPUTimer(Profiler::CPUSection section) :
+	m_section{section},
+	m_enabled{Profiler::isEnabled()}
+{
+	if (m_enabled)
+	{
+		m_start = Profiler::Clock::now();
+	}
+}
+
+CPUTimer::~CPUTimer()
+{
+	if (m_enabled)
+	{
+		Profiler::addCPUSample(m_section, m_start, Profiler::Clock::now());
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "profiler/profiler.hpp"
+
+class CPUTimer
+{
+public:
+	CPUTimer(Profiler::CPUSection section);
+	CPUTimer(const CPUTimer&) = delete;
+	CPUTimer(CPUTimer&&) = delete;
+	~CPUTimer();
+
+	CPUTimer& operator=(const CPUTimer&) = delete;
+	CPUTimer& operator=(CPUTimer&&) = delete;
+
+private:
+	Profiler::CPUSection m_section{};
+	bool m_enabled{};
+	Profiler::Clock::time_point m_start{};
+};
@@ -0,0 +1,19 @@
+#include "profiler/gpuTimer.hpp"
+
+GPUTimer::GPUTimer(Profiler::GPUPass pass) :
+	m_pass{pass},
+	m_enabled{Profiler::isEnabled()}
+{
+	if (m_enabled)
+	{
+		Profiler::beginGPUPass(m_pass);
+	}
+}
+
+GPUTimer::~GPUTimer()
+{
+	if (m_enabled)
+	{
+		Profiler::endGPUPass(m_pass);
+	}
+}
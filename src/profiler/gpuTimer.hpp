@@ -0,0 +1,19 @@
+#pragma once
+
+#include "profiler/profiler.hpp"
+
+class GPUTimer
+{
+public:
+	GPUTimer(Profiler::GPUPass pass);
+	GPUTimer(const GPUTimer&) = delete;
+	GPUTimer(GPUTimer&&) = delete;
+	~GPUTimer();
+
+	GPUTimer& operator=(const GPUTimer&) = delete;
+	GPUTimer& operator=(GPUTimer&&) = delete;
+
+private:
+	Profiler::GPUPass m_pass{};
+	bool m_enabled{};
+};
@@ -0,0 +1,305 @@
+#include "profiler/profiler.hpp"
+
+#include "profiler/traceRecorder.hpp"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace Profiler
+{
+	static constexpr std::size_t cpuSectionCount = static_cast<std::size_t>(CPUSection::count);
+	static constexpr std::size_t gpuPassCount = static_cast<std::size_t>(GPUPass::count);
+
+	// GPU results are read this many frames after the queries were issued so that reading them
+	// never stalls the pipeline
+	static constexpr std::size_t queryLatency = 4;
+
+	static const std::string csvPath = "profile.csv";
+	static const std::string tracePath = "profile.json";
+
+	static const std::array<const char*, cpuSectionCount> cpuSectionNames =
+	{
+		"frame",
+		"physics step",
+		"RHS",
+		"collisions",
+		"model updates",
+		"GUI"
+	};
+
+	static const std::array<const char*, gpuPassCount> gpuPassNames =
+	{
+		"mass points",
+		"internal springs",
+		"control cube",
+		"external springs",
+		"teapot",
+		"Bezier cube",
+		"constraint box",
+		"GUI"
+	};
+
+	struct GPUQueries
+	{
+		std::array<unsigned int, queryLatency> ids{};
+		std::array<bool, queryLatency> pending{};
+		std::array<Clock::time_point, queryLatency> issueTimes{};
+	};
+
+	static bool enabled = false;
+	static bool initialized = false;
+	static Clock::time_point initTime{};
+	static Clock::time_point frameStart{};
+	static std::size_t frameIndex = 0;
+
+	static std::array<float, cpuSectionCount> cpuAccumulators{};
+	static std::array<float, gpuPassCount> gpuResults{};
+	static std::array<SampleHistory, cpuSectionCount> cpuHistories{};
+	static std::array<SampleHistory, gpuPassCount> gpuHistories{};
+	static std::array<GPUQueries, gpuPassCount> gpuQueries{};
+
+	static std::ofstream csvFile{};
+	static bool traceOutput = false;
+	static TraceRecorder traceRecorder{};
+
+	static void collectGPUResults(std::size_t slot);
+	static void writeCSVHeader();
+	static void writeCSVRow();
+	static double toUs(Clock::time_point time);
+
+	void init()
+	{
+		for (GPUQueries& queries : gpuQueries)
+		{
+			glGenQueries(static_cast<GLsizei>(queryLatency), queries.ids.data());
+		}
+		initTime = Clock::now();
+		frameStart = initTime;
+		initialized = true;
+	}
+
+	void shutdown()
+	{
+		setCSVOutput(false);
+		setTraceOutput(false);
+		if (initialized)
+		{
+			for (GPUQueries& queries : gpuQueries)
+			{
+				glDeleteQueries(static_cast<GLsizei>(queryLatency), queries.ids.data());
+			}
+			initialized = false;
+		}
+	}
+
+	bool isEnabled()
+	{
+		return enabled;
+	}
+
+	void setEnabled(bool enabledValue)
+	{
+		enabled = enabledValue && initialized;
+	}
+
+	bool getCSVOutput()
+	{
+		return csvFile.is_open();
+	}
+
+	void setCSVOutput(bool csvOutput)
+	{
+		if (csvOutput == csvFile.is_open())
+		{
+			return;
+		}
+
+		if (csvOutput)
+		{
+			csvFile.open(csvPath);
+			if (!csvFile)
+			{
+				std::cerr << "Error writing profile:\n" << csvPath << '\n';
+				return;
+			}
+			writeCSVHeader();
+		}
+		else
+		{
+			csvFile.close();
+		}
+	}
+
+	bool getTraceOutput()
+	{
+		return traceOutput;
+	}
+
+	void setTraceOutput(bool traceOutputValue)
+	{
+		if (traceOutputValue == traceOutput)
+		{
+			return;
+		}
+
+		if (!traceOutputValue)
+		{
+			traceRecorder.write(tracePath);
+		}
+		traceRecorder.clear();
+		traceOutput = traceOutputValue;
+	}
+
+	void beginFrame()
+	{
+		frameStart = Clock::now();
+		if (!enabled)
+		{
+			return;
+		}
+
+		collectGPUResults(frameIndex % queryLatency);
+	}
+
+	void endFrame()
+	{
+		if (!enabled)
+		{
+			return;
+		}
+
+		addCPUSample(CPUSection::frame, frameStart, Clock::now());
+
+		for (std::size_t i = 0; i < cpuSectionCount; ++i)
+		{
+			cpuHistories[i].push(cpuAccumulators[i]);
+		}
+		for (std::size_t i = 0; i < gpuPassCount; ++i)
+		{
+			gpuHistories[i].push(gpuResults[i]);
+		}
+		if (csvFile.is_open())
+		{
+			writeCSVRow();
+		}
+
+		cpuAccumulators.fill(0);
+		++frameIndex;
+	}
+
+	void addCPUSample(CPUSection section, Clock::time_point start, Clock::time_point end)
+	{
+		std::chrono::duration<float, std::milli> duration = end - start;
+		cpuAccumulators[static_cast<std::size_t>(section)] += duration.count();
+		if (traceOutput)
+		{
+			double startUs = toUs(start);
+			traceRecorder.addEvent(getName(section), TraceRecorder::cpuThread, startUs,
+				toUs(end) - startUs);
+		}
+	}
+
+	void beginGPUPass(GPUPass pass)
+	{
+		GPUQueries& queries = gpuQueries[static_cast<std::size_t>(pass)];
+		std::size_t slot = frameIndex % queryLatency;
+		glBeginQuery(GL_TIME_ELAPSED, queries.ids[slot]);
+		queries.pending[slot] = true;
+		queries.issueTimes[slot] = Clock::now();
+	}
+
+	void endGPUPass(GPUPass)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	const SampleHistory& getHistory(CPUSection section)
+	{
+		return cpuHistories[static_cast<std::size_t>(section)];
+	}
+
+	const SampleHistory& getHistory(GPUPass pass)
+	{
+		return gpuHistories[static_cast<std::size_t>(pass)];
+	}
+
+	const char* getName(CPUSection section)
+	{
+		return cpuSectionNames[static_cast<std::size_t>(section)];
+	}
+
+	const char* getName(GPUPass pass)
+	{
+		return gpuPassNames[static_cast<std::size_t>(pass)];
+	}
+
+	static void collectGPUResults(std::size_t slot)
+	{
+		for (std::size_t i = 0; i < gpuPassCount; ++i)
+		{
+			GPUQueries& queries = gpuQueries[i];
+			gpuResults[i] = 0;
+			if (!queries.pending[slot])
+			{
+				continue;
+			}
+
+			int available{};
+			glGetQueryObjectiv(queries.ids[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+			{
+				continue;
+			}
+
+			std::uint64_t elapsedNs{};
+			glGetQueryObjectui64v(queries.ids[slot], GL_QUERY_RESULT, &elapsedNs);
+			queries.pending[slot] = false;
+			gpuResults[i] = static_cast<float>(elapsedNs) / 1e6f;
+
+			if (traceOutput)
+			{
+				traceRecorder.addEvent(gpuPassNames[i], TraceRecorder::gpuThread,
+					toUs(queries.issueTimes[slot]), static_cast<double>(elapsedNs) / 1e3);
+			}
+		}
+	}
+
+	static void writeCSVHeader()
+	{
+		csvFile << "frame";
+		for (const char* name : cpuSectionNames)
+		{
+			csvFile << ",CPU " << name << " [ms]";
+		}
+		for (const char* name : gpuPassNames)
+		{
+			csvFile << ",GPU " << name << " [ms]";
+		}
+		csvFile << '\n';
+	}
+
+	static void writeCSVRow()
+	{
+		csvFile << frameIndex;
+		for (float sample : cpuAccumulators)
+		{
+			csvFile << ',' << sample;
+		}
+		for (float sample : gpuResults)
+		{
+			csvFile << ',' << sample;
+		}
+		csvFile << '\n';
+	}
+
+	static double toUs(Clock::time_point time)
+	{
+		return std::chrono::duration<double, std::micro>(time - initTime).count();
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "profiler/sampleHistory.hpp"
+
+#include <chrono>
+
+namespace Profiler
+{
+	using Clock = std::chrono::steady_clock;
+
+	enum class CPUSection
+	{
+		frame,
+		physicsStep,
+		rhs,
+		collisions,
+		modelUpdates,
+		gui,
+		count
+	};
+
+	enum class GPUPass
+	{
+		massPoints,
+		internalSprings,
+		controlCube,
+		externalSprings,
+		teapot,
+		bezierCube,
+		constraintBox,
+		gui,
+		count
+	};
+
+	void init();
+	void shutdown();
+
+	bool isEnabled();
+	void setEnabled(bool enabled);
+	bool getCSVOutput();
+	void setCSVOutput(bool csvOutput);
+	bool getTraceOutput();
+	void setTraceOutput(bool traceOutput);
+
+	void beginFrame();
+	void endFrame();
+
+	void addCPUSample(CPUSection section, Clock::time_point start, Clock::time_point end);
+	void beginGPUPass(GPUPass pass);
+	void endGPUPass(GPUPass pass);
+
+	const SampleHistory& getHistory(CPUSection section);
+	const SampleHistory& getHistory(GPUPass pass);
+	const char* getName(CPUSection section);
+	const char* getName(GPUPass pass);
+}
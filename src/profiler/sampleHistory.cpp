@@ -0,0 +1,74 @@
+#include "profiler/sampleHistory.hpp"
+
+#include <algorithm>
+
+void SampleHistory::push(float sample)
+{
+	m_samples[m_next] = sample;
+	m_next = (m_next + 1) % length;
+	m_count = std::min(m_count + 1, length);
+}
+
+float SampleHistory::latest() const
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+	return m_samples[(m_next + length - 1) % length];
+}
+
+float SampleHistory::average() const
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+
+	float sum = 0;
+	for (std::size_t i = 0; i < m_count; ++i)
+	{
+		sum += m_samples[i];
+	}
+	return sum / m_count;
+}
+
+float SampleHistory::max() const
+{
+	if (m_count == 0)
+	{
+		return 0;
+	}
+	return *std::max_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+const float* SampleHistory::data() const
+{
+	return m_samples.data();
+}
+
+int SampleHistory::size() const
+{
+	return static_cast<int>(length);
+}
+
+int SampleHistory::offset() const
+{
+	return static_cast<int>(m_next);
+}
+
+std::array<float, SampleHistory::histogramBins> SampleHistory::histogram(float maxSample) const
+{
+	std::array<float, histogramBins> bins{};
+	if (m_count == 0 || maxSample <= 0)
+	{
+		return bins;
+	}
+
+	for (std::size_t i = 0; i < m_count; ++i)
+	{
+		std::size_t bin = static_cast<std::size_t>(m_samples[i] / maxSample * histogramBins);
+		++bins[std::min(bin, histogramBins - 1)];
+	}
+	return bins;
+}
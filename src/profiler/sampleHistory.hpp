@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+class SampleHistory
+{
+public:
+	static constexpr std::size_t length = 240;
+	static constexpr std::size_t histogramBins = 32;
+
+	void push(float sample);
+
+	float latest() const;
+	float average() const;
+	float max() const;
+
+	const float* data() const;
+	int size() const;
+	int offset() const;
+	std::array<float, histogramBins> histogram(float maxSample) const;
+
+private:
+	std::array<float, length> m_samples{};
+	std::size_t m_next = 0;
+	std::size_t m_count = 0;
+};
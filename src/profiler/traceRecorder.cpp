@@ -0,0 +1,41 @@
+#include "profiler/traceRecorder.hpp"
+
+#include <fstream>
+#include <iostream>
+
+void TraceRecorder::addEvent(const char* name, int thread, double startUs, double durationUs)
+{
+	if (m_events.size() >= maxEvents)
+	{
+		return;
+	}
+	m_events.push_back({name, thread, startUs, durationUs});
+}
+
+void TraceRecorder::clear()
+{
+	m_events.clear();
+}
+
+bool TraceRecorder::write(const std::string& path) const
+{
+	std::ofstream file{path};
+	if (!file)
+	{
+		std::cerr << "Error writing trace:\n" << path << '\n';
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << cpuThread <<
+		",\"args\":{\"name\":\"CPU\"}},\n";
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << gpuThread <<
+		",\"args\":{\"name\":\"GPU\"}}";
+	for (const Event& event : m_events)
+	{
+		file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" <<
+			event.thread << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs << '}';
+	}
+	file << "\n]}\n";
+	return true;
+}
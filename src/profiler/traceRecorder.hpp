@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class TraceRecorder
+{
+public:
+	static constexpr int cpuThread = 0;
+	static constexpr int gpuThread = 1;
+
+	void addEvent(const char* name, int thread, double startUs, double durationUs);
+	void clear();
+	bool write(const std::string& path) const;
+
+private:
+	static constexpr std::size_t maxEvents = 1 << 20;
+
+	struct Event
+	{
+		const char* name{};
+		int thread{};
+		double startUs{};
+		double durationUs{};
+	};
+
+	std::vector<Event> m_events{};
+};
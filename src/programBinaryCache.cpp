@@ -0,0 +1,141 @@
+#include "programBinaryCache.hpp"
+
+#include "mappedFile.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+
+std::uint64_t ProgramBinaryCache::key(const std::vector<std::string>& shaderCodes,
+	const std::vector<GLenum>& shaderTypes)
+{
+	// Binaries are only valid for the driver that produced them, so the driver strings are part
+	// of the key together with the sources.
+	std::uint64_t key = fnvOffsetBasis;
+	hashGLString(key, GL_VENDOR);
+	hashGLString(key, GL_RENDERER);
+	hashGLString(key, GL_VERSION);
+	for (std::size_t i = 0; i < shaderCodes.size(); ++i)
+	{
+		hash(key, &shaderTypes[i], sizeof(GLenum));
+		hash(key, shaderCodes[i].data(), shaderCodes[i].size());
+	}
+	return key;
+}
+
+std::optional<unsigned int> ProgramBinaryCache::load(std::uint64_t key)
+{
+	if (!isSupported())
+	{
+		return std::nullopt;
+	}
+
+	MappedFile file{path(key)};
+	std::string_view contents = file.getContents();
+	if (contents.size() < sizeof(Header))
+	{
+		return std::nullopt;
+	}
+
+	Header header{};
+	std::memcpy(&header, contents.data(), sizeof(Header));
+	if (header.magic != magic || header.key != key ||
+		contents.size() != sizeof(Header) + header.length)
+	{
+		return std::nullopt;
+	}
+
+	unsigned int program = glCreateProgram();
+	glProgramBinary(program, header.format, contents.data() + sizeof(Header),
+		static_cast<GLsizei>(header.length));
+	int success{};
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(program);
+		return std::nullopt;
+	}
+
+	return program;
+}
+
+void ProgramBinaryCache::save(unsigned int program, std::uint64_t key)
+{
+	if (!isSupported())
+	{
+		return;
+	}
+
+	int length{};
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(static_cast<std::size_t>(length));
+	GLenum format{};
+	glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+	std::string binaryPath = path(key);
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path{binaryPath}.parent_path(), error);
+	std::ofstream file{binaryPath, std::ios::binary | std::ios::trunc};
+	if (!file)
+	{
+		std::cerr << "Error writing program binary:\n" << binaryPath << '\n';
+		return;
+	}
+
+	Header header{};
+	header.magic = magic;
+	header.format = format;
+	header.key = key;
+	header.length = static_cast<std::uint64_t>(length);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	file.write(binary.data(), length);
+}
+
+bool ProgramBinaryCache::isSupported()
+{
+	static const bool isSupported =
+		[] ()
+		{
+			int formatCount{};
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+			return formatCount > 0;
+		}();
+	return isSupported;
+}
+
+std::string ProgramBinaryCache::path(std::uint64_t key)
+{
+	std::ostringstream stream{};
+	stream << "shaderCache/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+	return stream.str();
+}
+
+void ProgramBinaryCache::hash(std::uint64_t& hash, const void* data, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= fnvPrime;
+	}
+}
+
+void ProgramBinaryCache::hashGLString(std::uint64_t& hash, GLenum name)
+{
+	const char* string = reinterpret_cast<const char*>(glGetString(name));
+	if (string != nullptr)
+	{
+		ProgramBinaryCache::hash(hash, string, std::strlen(string));
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class ProgramBinaryCache
+{
+public:
+	ProgramBinaryCache() = delete;
+	static std::uint64_t key(const std::vector<std::string>& shaderCodes,
+		const std::vector<GLenum>& shaderTypes);
+	static std::optional<unsigned int> load(std::uint64_t key);
+	static void save(unsigned int program, std::uint64_t key);
+	~ProgramBinaryCache() = delete;
+
+private:
+	static constexpr std::uint32_t magic = 0x42505345; // "ESPB"
+	static constexpr std::uint64_t fnvOffsetBasis = 0xcbf29ce484222325;
+	static constexpr std::uint64_t fnvPrime = 0x100000001b3;
+
+	struct Header
+	{
+		std::uint32_t magic{};
+		std::uint32_t format{};
+		std::uint64_t key{};
+		std::uint64_t length{};
+	};
+
+	static bool isSupported();
+	static std::string path(std::uint64_t key);
+	static void hash(std::uint64_t& hash, const void* data, std::size_t size);
+	static void hashGLString(std::uint64_t& hash, GLenum name);
+};
@@ -1,21 +1,27 @@
 #include "scene.hpp"
 
 #include "mesh.hpp"
-#include "objParser.hpp"
+#include "meshLoader.hpp"
+#include "profiler/cpuTimer.hpp"
+#include "profiler/gpuTimer.hpp"
 #include "shaderPrograms.hpp"
 
 #include <glad/glad.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
 static constexpr float nearPlane = 0.1f;
 static constexpr float farPlane = 1000.0f;
 static constexpr float initFOVYDeg = 60.0f;
+static constexpr glm::vec4 teapotColor{1, 1, 1, 1};
 
 Scene::Scene(const glm::ivec2& viewportSize) :
 	m_camera{viewportSize, nearPlane, farPlane, initFOVYDeg}
@@ -43,9 +49,12 @@ Scene::Scene(const glm::ivec2& viewportSize) :
 	m_bezierCubeModel = std::make_unique<Model>(bezierCubeMesh(Simulation::cubeSize),
 		*ShaderPrograms::bezier, bezierCubeColor);
 
-	static constexpr glm::vec4 teapotColor{1, 1, 1, 1};
-	m_teapotModel = std::make_unique<Model>(objMesh("res/teapot.obj"), *ShaderPrograms::teapot,
-		teapotColor);
+	m_pendingTeapotLODs = AsyncLoad<std::vector<IndexedMesh>>
+	{
+		[] () { return objMeshLODs("res/teapot.obj"); }
+	};
+	m_teapotModel = std::make_unique<FFDModel>(ffdMeshes({teapotPlaceholderMesh()}),
+		*ShaderPrograms::teapot, ShaderPrograms::ffd.get(), teapotColor);
 
 	static constexpr glm::vec4 internalSpringsColor{1, 1, 1, 1};
 	m_internalSpringsModel = std::make_unique<Model>(internalSpringsMesh(Simulation::cubeSize),
@@ -65,8 +74,11 @@ Scene::Scene(const glm::ivec2& viewportSize) :
 
 void Scene::update()
 {
-	m_simulation->update();
-	updateTeapotShader();
+	m_frameArena.reset();
+	updateAssets();
+	m_simulation->update({m_renderMassPoints, m_renderBezierCube, m_renderInternalSprings,
+		m_renderControlCube, m_renderExternalSprings}, &m_frameArena);
+	updateTeapotModel();
 }
 
 void Scene::render() const
@@ -79,6 +91,7 @@ void Scene::render() const
 
 	if (m_renderMassPoints)
 	{
+		GPUTimer timer{Profiler::GPUPass::massPoints};
 		for (const std::unique_ptr<Model>& massPointModel : m_massPointModels)
 		{
 			massPointModel->render();
@@ -86,27 +99,34 @@ void Scene::render() const
 	}
 	if (m_renderInternalSprings)
 	{
+		GPUTimer timer{Profiler::GPUPass::internalSprings};
 		m_internalSpringsModel->render();
 	}
 	if (m_renderControlCube)
 	{
+		GPUTimer timer{Profiler::GPUPass::controlCube};
 		m_controlCubeModel->render();
 	}
 	if (m_renderExternalSprings)
 	{
+		GPUTimer timer{Profiler::GPUPass::externalSprings};
 		m_externalSpringsModel->render();
 	}
 	if (m_renderTeapot)
 	{
+		GPUTimer timer{Profiler::GPUPass::teapot};
 		m_teapotModel->render();
 	}
 	if (m_renderBezierCube)
 	{
+		GPUTimer timer{Profiler::GPUPass::bezierCube};
+		updateBezierShader();
 		m_bezierCubeTexture.use();
 		m_bezierCubeModel->render();
 	}
 	if (m_renderConstraintBox)
 	{
+		GPUTimer timer{Profiler::GPUPass::constraintBox};
 		m_constraintBoxModel->render();
 	}
 }
@@ -211,11 +231,58 @@ void Scene::setRenderExternalSprings(bool renderExternalSprings)
 	m_renderExternalSprings = renderExternalSprings;
 }
 
+float Scene::getMinTessLevel() const
+{
+	return m_minTessLevel;
+}
+
+void Scene::setMinTessLevel(float minTessLevel)
+{
+	m_minTessLevel = minTessLevel;
+	m_maxTessLevel = std::max(m_maxTessLevel, m_minTessLevel);
+}
+
+float Scene::getMaxTessLevel() const
+{
+	return m_maxTessLevel;
+}
+
+void Scene::setMaxTessLevel(float maxTessLevel)
+{
+	m_maxTessLevel = maxTessLevel;
+	m_minTessLevel = std::min(m_minTessLevel, m_maxTessLevel);
+}
+
+float Scene::getLODDistance() const
+{
+	return m_lodDistance;
+}
+
+void Scene::setLODDistance(float lodDistance)
+{
+	m_lodDistance = lodDistance;
+}
+
+std::size_t Scene::getTeapotLOD() const
+{
+	return m_teapotModel->getLOD();
+}
+
+bool Scene::isLoadingAssets() const
+{
+	return m_bezierCubeTexture.isLoading() || m_pendingTeapotLODs.isPending();
+}
+
 Simulation& Scene::getSimulation()
 {
 	return *m_simulation;
 }
 
+const Arena& Scene::getFrameArena() const
+{
+	return m_frameArena;
+}
+
 Mesh Scene::cubeLineMesh(const glm::vec3& size)
 {
 	std::vector<Mesh::Vertex> vertices{};
@@ -370,15 +437,19 @@ Mesh Scene::externalSpringsMesh(const glm::vec3& size)
 	return Mesh{vertices, indices, true, true};
 }
 
-Mesh Scene::objMesh(const std::string& path)
+std::vector<IndexedMesh> Scene::objMeshLODs(const std::string& path)
 {
-	std::vector<Mesh::Vertex> vertices = ObjParser::parse(path);
+	std::vector<IndexedMesh> lods = MeshLoader::loadLODs(path, teapotLODCount);
+	if (lods.empty())
+	{
+		return lods;
+	}
 
 	static constexpr float maxFloat = std::numeric_limits<float>::max();
 	glm::vec3 minPos{maxFloat, maxFloat, maxFloat};
 	glm::vec3 maxPos{-maxFloat, -maxFloat, -maxFloat};
 
-	for (const Mesh::Vertex& vertex : vertices)
+	for (const Mesh::Vertex& vertex : lods[0].vertices)
 	{
 		if (vertex.pos.x < minPos.x)
 		{
@@ -410,28 +481,128 @@ Mesh Scene::objMesh(const std::string& path)
 	glm::vec3 scales = 1.0f / (maxPos - minPos);
 	float scale = std::min(scales.x, std::min(scales.y, scales.z));
 
-	for (Mesh::Vertex& vertex : vertices)
+	for (IndexedMesh& lod : lods)
 	{
-		vertex.pos -= mean;
-		vertex.pos *= scale;
-		vertex.pos += 0.5f;
+		for (Mesh::Vertex& vertex : lod.vertices)
+		{
+			vertex.pos -= mean;
+			vertex.pos *= scale;
+			vertex.pos += 0.5f;
+		}
 	}
 
-	std::vector<unsigned int> indices{};
-	for (unsigned int i = 0; i < vertices.size(); ++i)
+	return lods;
+}
+
+IndexedMesh Scene::teapotPlaceholderMesh()
+{
+	static constexpr float minPos = 0.25f;
+	static constexpr float maxPos = 0.75f;
+
+	IndexedMesh mesh{};
+	for (int axis = 0; axis < 3; ++axis)
 	{
-		indices.push_back(i);
+		int uAxis = (axis + 1) % 3;
+		int vAxis = (axis + 2) % 3;
+		for (int side = 0; side < 2; ++side)
+		{
+			glm::vec3 normalVector{};
+			normalVector[axis] = side == 0 ? -1.0f : 1.0f;
+
+			unsigned int firstVertex = static_cast<unsigned int>(mesh.vertices.size());
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				glm::vec3 pos{};
+				pos[axis] = side == 0 ? minPos : maxPos;
+				pos[uAxis] = corner == 1 || corner == 2 ? maxPos : minPos;
+				pos[vAxis] = corner >= 2 ? maxPos : minPos;
+				mesh.vertices.push_back({pos, normalVector});
+			}
+
+			std::array<unsigned int, 6> indices = side == 0 ?
+				std::array<unsigned int, 6>{0, 2, 1, 0, 3, 2} :
+				std::array<unsigned int, 6>{0, 1, 2, 0, 2, 3};
+			for (unsigned int index : indices)
+			{
+				mesh.indices.push_back(firstVertex + index);
+			}
+		}
+	}
+
+	return mesh;
+}
+
+std::vector<FFDMesh> Scene::ffdMeshes(const std::vector<IndexedMesh>& meshes)
+{
+	std::vector<FFDMesh> ffdMeshes{};
+	for (const IndexedMesh& mesh : meshes)
+	{
+		ffdMeshes.emplace_back(mesh.vertices, mesh.indices);
 	}
+	return ffdMeshes;
+}
+
+void Scene::updateAssets()
+{
+	m_bezierCubeTexture.update();
 
-	return Mesh{vertices, indices, GL_TRIANGLES};
+	std::optional<std::vector<IndexedMesh>> teapotLODs = m_pendingTeapotLODs.poll();
+	if (teapotLODs && !teapotLODs->empty())
+	{
+		m_teapotModel = std::make_unique<FFDModel>(ffdMeshes(*teapotLODs),
+			*ShaderPrograms::teapot, ShaderPrograms::ffd.get(), teapotColor);
+		m_teapotGeneration = Simulation::noGeneration;
+	}
 }
 
-void Scene::updateTeapotShader() const
+void Scene::updateTeapotModel()
 {
-	ShaderPrograms::teapot->use();
-	std::vector<glm::vec3> vertices = m_simulation->getElasticCube().getVertices();
-	for (int i = 0; i < vertices.size(); ++i)
+	if (!m_renderTeapot)
 	{
-		ShaderPrograms::teapot->setUniform("bezierPoints[" + std::to_string(i) + "]", vertices[i]);
+		return;
 	}
+
+	CPUTimer timer{Profiler::CPUSection::modelUpdates};
+	std::span<const glm::vec3> controlPoints = m_simulation->getElasticCube().getVertices();
+
+	glm::vec3 center{};
+	for (const glm::vec3& controlPoint : controlPoints)
+	{
+		center += controlPoint;
+	}
+	center /= static_cast<float>(controlPoints.size());
+	m_teapotModel->setLOD(lodForDistance(glm::distance(m_camera.getPos(), center)));
+
+	if (m_teapotGeneration == m_simulation->getRenderGeneration() &&
+		m_teapotDeformedLOD == m_teapotModel->getLOD())
+	{
+		return;
+	}
+	m_teapotModel->deform(controlPoints, &m_frameArena);
+	m_teapotGeneration = m_simulation->getRenderGeneration();
+	m_teapotDeformedLOD = m_teapotModel->getLOD();
+}
+
+std::size_t Scene::lodForDistance(float distance) const
+{
+	// Each level has a quarter of the triangles of the previous one, which keeps the projected
+	// triangle size roughly constant when the distance doubles.
+	if (distance < m_lodDistance)
+	{
+		return 0;
+	}
+
+	return static_cast<std::size_t>(std::log2(distance / m_lodDistance)) + 1;
+}
+
+void Scene::updateBezierShader() const
+{
+	if (!ShaderPrograms::bezier->isReady())
+	{
+		return;
+	}
+
+	ShaderPrograms::bezier->use();
+	ShaderPrograms::bezier->setUniform("minTessLevel", m_minTessLevel);
+	ShaderPrograms::bezier->setUniform("maxTessLevel", m_maxTessLevel);
 }
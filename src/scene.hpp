@@ -1,6 +1,10 @@
 #pragma once
 
+#include "arena.hpp"
+#include "asyncLoad.hpp"
 #include "camera/perspectiveCamera.hpp"
+#include "ffdModel.hpp"
+#include "indexedMesh.hpp"
 #include "model.hpp"
 #include "simulation.hpp"
 #include "texture.hpp"
@@ -8,8 +12,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 class Scene
 {
@@ -40,7 +47,19 @@ public:
 	bool getRenderExternalSprings() const;
 	void setRenderExternalSprings(bool renderExternalSprings);
 
+	float getMinTessLevel() const;
+	void setMinTessLevel(float minTessLevel);
+	float getMaxTessLevel() const;
+	void setMaxTessLevel(float maxTessLevel);
+
+	float getLODDistance() const;
+	void setLODDistance(float lodDistance);
+	std::size_t getTeapotLOD() const;
+	bool isLoadingAssets() const;
+
 	Simulation& getSimulation();
+	// Scratch memory of the scene update, reset every frame.
+	const Arena& getFrameArena() const;
 
 private:
 	PerspectiveCamera m_camera;
@@ -51,9 +70,13 @@ private:
 	std::unique_ptr<Model> m_internalSpringsModel{};
 	std::unique_ptr<Model> m_controlCubeModel{};
 	std::unique_ptr<Model> m_externalSpringsModel{};
-	std::unique_ptr<Model> m_teapotModel{};
+	std::unique_ptr<FFDModel> m_teapotModel{};
+	// Simulation state generation and LOD the teapot was last deformed with.
+	std::uint64_t m_teapotGeneration = Simulation::noGeneration;
+	std::size_t m_teapotDeformedLOD{};
 
 	Texture m_bezierCubeTexture{"res/sponge.jpg"};
+	AsyncLoad<std::vector<IndexedMesh>> m_pendingTeapotLODs{};
 
 	bool m_renderMassPoints = false;
 	bool m_renderConstraintBox = true;
@@ -63,14 +86,29 @@ private:
 	bool m_renderControlCube = true;
 	bool m_renderExternalSprings = false;
 
+	float m_minTessLevel = 1;
+	float m_maxTessLevel = 32;
+
+	static constexpr std::size_t teapotLODCount = 4;
+	float m_lodDistance = 12;
+
 	std::unique_ptr<Simulation> m_simulation{};
 
+	static constexpr std::size_t frameArenaCapacity = 1 << 16;
+	Arena m_frameArena{frameArenaCapacity};
+
 	static Mesh cubeLineMesh(const glm::vec3& size);
 	static Mesh cubeMesh(const glm::vec3& size);
 	static Mesh bezierCubeMesh(const glm::vec3& size);
 	static Mesh internalSpringsMesh(const glm::vec3& size);
 	static Mesh externalSpringsMesh(const glm::vec3& size);
-	static Mesh objMesh(const std::string& path);
+	static std::vector<IndexedMesh> objMeshLODs(const std::string& path);
+	static IndexedMesh teapotPlaceholderMesh();
+	static std::vector<FFDMesh> ffdMeshes(const std::vector<IndexedMesh>& meshes);
+
+	void updateAssets();
 
-	void updateTeapotShader() const;
+	void updateTeapotModel();
+	std::size_t lodForDistance(float distance) const;
+	void updateBezierShader() const;
 };
@@ -1,15 +1,33 @@
 #include "shaderProgram.hpp"
 
+#include "programBinaryCache.hpp"
+
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <utility>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 static constexpr std::size_t errorLogSize = 512;
 
+ShaderProgram::ShaderProgram(const std::string& computeShaderPath) :
+	ShaderProgram
+	{
+		std::vector<std::string>{computeShaderPath},
+		std::vector<GLenum>{GL_COMPUTE_SHADER}
+	}
+{ }
+
 ShaderProgram::ShaderProgram(const std::string& vertexShaderPath,
 	const std::string& fragmentShaderPath) :
 	ShaderProgram
@@ -40,14 +58,83 @@ ShaderProgram::ShaderProgram(const std::string& vertexShaderPath,
 
 ShaderProgram::~ShaderProgram()
 {
+	discardReload();
+	deleteShaders(m_shaders);
 	glDeleteProgram(m_id);
 }
 
+bool ShaderProgram::isReady() const
+{
+	if (m_isReady)
+	{
+		return true;
+	}
+
+	if (!isBuildComplete(m_id))
+	{
+		return false;
+	}
+
+	finishLinking();
+	return true;
+}
+
 void ShaderProgram::use() const
 {
+	if (!m_isReady)
+	{
+		finishLinking();
+	}
 	glUseProgram(m_id);
 }
 
+const std::vector<std::string>& ShaderProgram::getShaderPaths() const
+{
+	return m_shaderPaths;
+}
+
+void ShaderProgram::reload()
+{
+	discardReload();
+	m_reloadBuild = startBuild();
+}
+
+bool ShaderProgram::updateReload()
+{
+	if (m_reloadBuild.id == 0)
+	{
+		return false;
+	}
+
+	if (!m_reloadBuild.isLinked)
+	{
+		if (!isBuildComplete(m_reloadBuild.id))
+		{
+			return false;
+		}
+		if (!finishBuild(m_reloadBuild.id, m_reloadBuild.shaders, m_reloadBuild.binaryKey))
+		{
+			std::cerr << "Keeping previous shader program:\n" << m_shaderPaths[0] << '\n';
+			discardReload();
+			return false;
+		}
+	}
+
+	if (!m_isReady)
+	{
+		finishLinking();
+	}
+
+	// The new program replaces the old one under the same object, so models holding a reference
+	// to this program pick it up on their next draw with all uniform values carried over.
+	copyUniforms(m_id, m_reloadBuild.id);
+	glDeleteProgram(m_id);
+	m_id = m_reloadBuild.id;
+	m_binaryKey = m_reloadBuild.binaryKey;
+	m_reloadBuild = Build{};
+	return true;
+}
+
 void ShaderProgram::setUniform(const std::string& name, bool value) const
 {
 	glUniform1i(glGetUniformLocation(m_id, name.c_str()), static_cast<int>(value));
@@ -95,32 +182,217 @@ void ShaderProgram::setUniform(const std::string& name, const glm::mat4& value)
 		glm::value_ptr(value));
 }
 
+void ShaderProgram::setUniform(const std::string& name, std::span<const glm::vec3> values) const
+{
+	glUniform3fv(glGetUniformLocation(m_id, name.c_str()), static_cast<GLsizei>(values.size()),
+		glm::value_ptr(values.front()));
+}
+
 ShaderProgram::ShaderProgram(const std::vector<std::string>& shaderPaths,
-	const std::vector<GLenum>& shaderTypes)
+	const std::vector<GLenum>& shaderTypes) :
+	m_shaderPaths{shaderPaths},
+	m_shaderTypes{shaderTypes}
 {
-	std::vector<unsigned int> shaders{};
-	for (int i = 0; i < shaderPaths.size(); ++i)
+	Build build = startBuild();
+	m_id = build.id;
+	m_binaryKey = build.binaryKey;
+	m_shaders = std::move(build.shaders);
+	m_isReady = build.isLinked;
+}
+
+ShaderProgram::Build ShaderProgram::startBuild() const
+{
+	std::vector<std::string> shaderCodes{};
+	for (const std::string& shaderPath : m_shaderPaths)
+	{
+		shaderCodes.push_back(readShaderFile(shaderPath));
+	}
+
+	Build build{};
+	build.binaryKey = ProgramBinaryCache::key(shaderCodes, m_shaderTypes);
+	std::optional<unsigned int> cachedProgram = ProgramBinaryCache::load(build.binaryKey);
+	if (cachedProgram)
+	{
+		build.id = *cachedProgram;
+		build.isLinked = true;
+		return build;
+	}
+
+	for (std::size_t i = 0; i < shaderCodes.size(); ++i)
+	{
+		build.shaders.push_back(createShader(shaderCodes[i], m_shaderTypes[i]));
+	}
+	build.id = createShaderProgram(build.shaders);
+	return build;
+}
+
+bool ShaderProgram::finishBuild(unsigned int id, std::vector<unsigned int>& shaders,
+	std::uint64_t binaryKey) const
+{
+	// Querying the compile and link status waits for the driver, so it is deferred until the
+	// program is needed or reported complete by KHR_parallel_shader_compile.
+	for (std::size_t i = 0; i < shaders.size(); ++i)
+	{
+		int success{};
+		glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			printCompilationError(shaders[i], m_shaderTypes[i]);
+		}
+	}
+
+	int success{};
+	glGetProgramiv(id, GL_LINK_STATUS, &success);
+	if (success)
+	{
+		ProgramBinaryCache::save(id, binaryKey);
+	}
+	else
 	{
-		shaders.push_back(createShader(shaderPaths[i], shaderTypes[i]));
+		printLinkingError(id);
 	}
-	m_id = createShaderProgram(shaders);
+
 	deleteShaders(shaders);
+	shaders.clear();
+	return success;
+}
+
+void ShaderProgram::finishLinking() const
+{
+	finishBuild(m_id, m_shaders, m_binaryKey);
+	m_isReady = true;
+}
+
+void ShaderProgram::discardReload()
+{
+	if (m_reloadBuild.id == 0)
+	{
+		return;
+	}
+
+	deleteShaders(m_reloadBuild.shaders);
+	glDeleteProgram(m_reloadBuild.id);
+	m_reloadBuild = Build{};
+}
+
+bool ShaderProgram::isBuildComplete(unsigned int id)
+{
+	if (!isParallelCompileSupported())
+	{
+		return true;
+	}
+
+	int isComplete{};
+	glGetProgramiv(id, GL_COMPLETION_STATUS_KHR, &isComplete);
+	return isComplete;
 }
 
-unsigned int ShaderProgram::createShader(const std::string& shaderPath, GLenum shaderType)
+void ShaderProgram::copyUniforms(unsigned int sourceProgram, unsigned int targetProgram)
 {
-	std::string shaderCode = readShaderFile(shaderPath);
+	int uniformCount{};
+	glGetProgramiv(sourceProgram, GL_ACTIVE_UNIFORMS, &uniformCount);
+	int maxNameLength{};
+	glGetProgramiv(sourceProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	std::vector<char> nameBuffer(static_cast<std::size_t>(std::max(maxNameLength, 1)));
+	for (int i = 0; i < uniformCount; ++i)
+	{
+		int size{};
+		GLenum type{};
+		glGetActiveUniform(sourceProgram, static_cast<unsigned int>(i),
+			static_cast<GLsizei>(nameBuffer.size()), nullptr, &size, &type, nameBuffer.data());
+
+		std::string name = nameBuffer.data();
+		static constexpr std::string_view arraySuffix = "[0]";
+		if (name.size() > arraySuffix.size() &&
+			name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+		{
+			name.resize(name.size() - arraySuffix.size());
+		}
+
+		for (int element = 0; element < size; ++element)
+		{
+			std::string elementName = size > 1 ? name + '[' + std::to_string(element) + ']' : name;
+			int sourceLocation = glGetUniformLocation(sourceProgram, elementName.c_str());
+			int targetLocation = glGetUniformLocation(targetProgram, elementName.c_str());
+			if (sourceLocation != -1 && targetLocation != -1)
+			{
+				copyUniform(sourceProgram, sourceLocation, targetProgram, targetLocation, type);
+			}
+		}
+	}
+}
 
+void ShaderProgram::copyUniform(unsigned int sourceProgram, int sourceLocation,
+	unsigned int targetProgram, int targetLocation, GLenum type)
+{
+	std::array<float, 16> floats{};
+	std::array<int, 4> ints{};
+	switch (type)
+	{
+		case GL_FLOAT:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniform1fv(targetProgram, targetLocation, 1, floats.data());
+			break;
+
+		case GL_FLOAT_VEC2:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniform2fv(targetProgram, targetLocation, 1, floats.data());
+			break;
+
+		case GL_FLOAT_VEC3:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniform3fv(targetProgram, targetLocation, 1, floats.data());
+			break;
+
+		case GL_FLOAT_VEC4:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniform4fv(targetProgram, targetLocation, 1, floats.data());
+			break;
+
+		case GL_FLOAT_MAT3:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniformMatrix3fv(targetProgram, targetLocation, 1, GL_FALSE, floats.data());
+			break;
+
+		case GL_FLOAT_MAT4:
+			glGetUniformfv(sourceProgram, sourceLocation, floats.data());
+			glProgramUniformMatrix4fv(targetProgram, targetLocation, 1, GL_FALSE, floats.data());
+			break;
+
+		case GL_INT:
+		case GL_BOOL:
+		case GL_SAMPLER_2D:
+			glGetUniformiv(sourceProgram, sourceLocation, ints.data());
+			glProgramUniform1iv(targetProgram, targetLocation, 1, ints.data());
+			break;
+
+		case GL_INT_VEC2:
+		case GL_BOOL_VEC2:
+			glGetUniformiv(sourceProgram, sourceLocation, ints.data());
+			glProgramUniform2iv(targetProgram, targetLocation, 1, ints.data());
+			break;
+
+		case GL_INT_VEC3:
+		case GL_BOOL_VEC3:
+			glGetUniformiv(sourceProgram, sourceLocation, ints.data());
+			glProgramUniform3iv(targetProgram, targetLocation, 1, ints.data());
+			break;
+
+		case GL_INT_VEC4:
+		case GL_BOOL_VEC4:
+			glGetUniformiv(sourceProgram, sourceLocation, ints.data());
+			glProgramUniform4iv(targetProgram, targetLocation, 1, ints.data());
+			break;
+	}
+}
+
+unsigned int ShaderProgram::createShader(const std::string& shaderCode, GLenum shaderType)
+{
 	unsigned int shader = glCreateShader(shaderType);
 	const char* shaderCodeCStr = shaderCode.c_str();
 	glShaderSource(shader, 1, &shaderCodeCStr, NULL);
 	glCompileShader(shader);
-	int success{};
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		printCompilationError(shader, shaderType);
-	}
 	return shader;
 }
 
@@ -131,13 +403,8 @@ unsigned int ShaderProgram::createShaderProgram(const std::vector<unsigned int>&
 	{
 		glAttachShader(shaderProgram, shader);
 	}
+	glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(shaderProgram);
-	int success{};
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		printLinkingError(shaderProgram);
-	}
 	return shaderProgram;
 }
 
@@ -149,6 +416,29 @@ void ShaderProgram::deleteShaders(const std::vector<unsigned int>& shaders)
 	}
 }
 
+bool ShaderProgram::isParallelCompileSupported()
+{
+	static const bool isSupported =
+		[] ()
+		{
+			int extensionCount{};
+			glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+			for (int i = 0; i < extensionCount; ++i)
+			{
+				const char* extension = reinterpret_cast<const char*>(
+					glGetStringi(GL_EXTENSIONS, static_cast<unsigned int>(i)));
+				if (extension != nullptr && (std::string_view{extension} ==
+					"GL_KHR_parallel_shader_compile" ||
+					std::string_view{extension} == "GL_ARB_parallel_shader_compile"))
+				{
+					return true;
+				}
+			}
+			return false;
+		}();
+	return isSupported;
+}
+
 std::string ShaderProgram::readShaderFile(const std::string& shaderPath)
 {
 	std::string shaderCode{};
@@ -197,6 +487,10 @@ void ShaderProgram::printCompilationError(unsigned int shader, GLenum shaderType
 		case GL_FRAGMENT_SHADER:
 			shaderTypeName = "fragment";
 			break;
+
+		case GL_COMPUTE_SHADER:
+			shaderTypeName = "compute";
+			break;
 	}
 	std::cerr << "Error compiling " + shaderTypeName + " shader:\n" << errorLog.data() << '\n';
 }
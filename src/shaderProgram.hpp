@@ -3,12 +3,15 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
 class ShaderProgram
 {
 public:
+	ShaderProgram(const std::string& computeShaderPath);
 	ShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
 	ShaderProgram(const std::string& vertexShaderPath, const std::string& geometryShaderPath,
 		const std::string& fragmentShaderPath);
@@ -21,8 +24,13 @@ public:
 	ShaderProgram& operator=(const ShaderProgram&) = delete;
 	ShaderProgram& operator=(ShaderProgram&&) = delete;
 
+	bool isReady() const;
 	void use() const;
 
+	const std::vector<std::string>& getShaderPaths() const;
+	void reload();
+	bool updateReload();
+
 	void setUniform(const std::string& name, bool value) const;
 	void setUniform(const std::string& name, int value) const;
 	void setUniform(const std::string& name, float value) const;
@@ -32,16 +40,45 @@ public:
 	void setUniform(const std::string& name, const glm::vec4& value) const;
 	void setUniform(const std::string& name, const glm::mat3& value) const;
 	void setUniform(const std::string& name, const glm::mat4& value) const;
+	void setUniform(const std::string& name, std::span<const glm::vec3> values) const;
 
 private:
+	struct Build
+	{
+		unsigned int id{};
+		std::uint64_t binaryKey{};
+		std::vector<unsigned int> shaders{};
+		bool isLinked = false;
+	};
+
+	std::vector<std::string> m_shaderPaths{};
+	std::vector<GLenum> m_shaderTypes{};
+
 	unsigned int m_id{};
+	std::uint64_t m_binaryKey{};
+	mutable std::vector<unsigned int> m_shaders{};
+	mutable bool m_isReady = false;
+
+	Build m_reloadBuild{};
 
 	ShaderProgram(const std::vector<std::string>& shaderPaths,
 		const std::vector<GLenum>& shaderTypes);
 
-	static unsigned int createShader(const std::string& shaderPath, GLenum shaderType);
+	Build startBuild() const;
+	bool finishBuild(unsigned int id, std::vector<unsigned int>& shaders,
+		std::uint64_t binaryKey) const;
+	void finishLinking() const;
+	void discardReload();
+
+	static bool isBuildComplete(unsigned int id);
+	static void copyUniforms(unsigned int sourceProgram, unsigned int targetProgram);
+	static void copyUniform(unsigned int sourceProgram, int sourceLocation,
+		unsigned int targetProgram, int targetLocation, GLenum type);
+
+	static unsigned int createShader(const std::string& shaderCode, GLenum shaderType);
 	static unsigned int createShaderProgram(const std::vector<unsigned int>& shaders);
 	static void deleteShaders(const std::vector<unsigned int>& shaders);
+	static bool isParallelCompileSupported();
 
 	static std::string readShaderFile(const std::string& shaderPath);
 	static void printCompilationError(unsigned int shaderId, GLenum shaderType);
@@ -1,25 +1,84 @@
 #include "shaderPrograms.hpp"
 
+#include "shaderWatcher.hpp"
+
+#include <algorithm>
+#include <iostream>
 #include <string>
+#include <vector>
 
 namespace ShaderPrograms
 {
 	std::string path(const std::string& shaderName);
+	std::vector<ShaderProgram*> programs();
+
+	std::unique_ptr<ShaderProgram> bezier{};
+	std::unique_ptr<ShaderProgram> teapot{};
+	std::unique_ptr<ShaderProgram> lines{};
+	std::unique_ptr<ShaderProgram> ffd{};
 
-	std::unique_ptr<const ShaderProgram> bezier{};
-	std::unique_ptr<const ShaderProgram> teapot{};
-	std::unique_ptr<const ShaderProgram> lines{};
+	std::unique_ptr<ShaderWatcher> watcher{};
 
 	void init()
 	{
-		bezier = std::make_unique<const ShaderProgram>(path("bezierVS"), path("bezierTCS"),
+		bezier = std::make_unique<ShaderProgram>(path("bezierVS"), path("bezierTCS"),
 			path("bezierTES"), path("bezierFS"));
-		teapot = std::make_unique<const ShaderProgram>(path("teapotVS"), path("teapotFS"));
-		lines = std::make_unique<const ShaderProgram>(path("linesVS"), path("linesFS"));
+		teapot = std::make_unique<ShaderProgram>(path("teapotVS"), path("teapotFS"));
+		lines = std::make_unique<ShaderProgram>(path("linesVS"), path("linesFS"));
+		if (GLAD_GL_VERSION_4_3)
+		{
+			ffd = std::make_unique<ShaderProgram>(path("ffdCS"));
+		}
+
+		std::vector<std::string> shaderPaths{};
+		for (const ShaderProgram* program : programs())
+		{
+			for (const std::string& shaderPath : program->getShaderPaths())
+			{
+				shaderPaths.push_back(shaderPath);
+			}
+		}
+		watcher = std::make_unique<ShaderWatcher>(shaderPaths);
+	}
+
+	void update()
+	{
+		std::vector<std::string> changedPaths = watcher->takeChangedPaths();
+		for (ShaderProgram* program : programs())
+		{
+			const std::vector<std::string>& shaderPaths = program->getShaderPaths();
+			bool isChanged = std::any_of(shaderPaths.begin(), shaderPaths.end(),
+				[&changedPaths] (const std::string& shaderPath)
+				{
+					return std::find(changedPaths.begin(), changedPaths.end(), shaderPath) !=
+						changedPaths.end();
+				}
+			);
+			if (isChanged)
+			{
+				std::cerr << "Reloading shader program:\n" << shaderPaths[0] << '\n';
+				program->reload();
+			}
+
+			program->updateReload();
+		}
 	}
 
 	std::string path(const std::string& shaderName)
 	{
 		return "src/shaders/" + shaderName + ".glsl";
 	}
+
+	std::vector<ShaderProgram*> programs()
+	{
+		std::vector<ShaderProgram*> programs{};
+		for (const std::unique_ptr<ShaderProgram>* program : {&bezier, &teapot, &lines, &ffd})
+		{
+			if (*program)
+			{
+				programs.push_back(program->get());
+			}
+		}
+		return programs;
+	}
 }
@@ -7,8 +7,10 @@
 namespace ShaderPrograms
 {
 	void init();
+	void update();
 
-	extern std::unique_ptr<const ShaderProgram> bezier;
-	extern std::unique_ptr<const ShaderProgram> teapot;
-	extern std::unique_ptr<const ShaderProgram> lines;
+	extern std::unique_ptr<ShaderProgram> bezier;
+	extern std::unique_ptr<ShaderProgram> teapot;
+	extern std::unique_ptr<ShaderProgram> lines;
+	extern std::unique_ptr<ShaderProgram> ffd;
 }
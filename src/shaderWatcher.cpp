@@ -0,0 +1,70 @@
+#include "shaderWatcher.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+
+ShaderWatcher::ShaderWatcher(const std::vector<std::string>& paths) :
+	m_paths{paths}
+{
+	for (const std::string& path : m_paths)
+	{
+		m_writeTimes.push_back(writeTime(path));
+	}
+	m_thread = std::thread{[this] () { watch(); }};
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_stop = true;
+	}
+	m_stopCondition.notify_one();
+	m_thread.join();
+}
+
+std::vector<std::string> ShaderWatcher::takeChangedPaths()
+{
+	std::lock_guard<std::mutex> lock{m_mutex};
+	return std::exchange(m_changedPaths, std::vector<std::string>{});
+}
+
+void ShaderWatcher::watch()
+{
+	// Modification times are polled instead of using OS change notifications so the watcher
+	// works the same on every platform; a few stat calls per interval are negligible.
+	std::unique_lock<std::mutex> lock{m_mutex};
+	while (!m_stopCondition.wait_for(lock, pollInterval, [this] () { return m_stop; }))
+	{
+		lock.unlock();
+		std::vector<std::string> changedPaths{};
+		for (std::size_t i = 0; i < m_paths.size(); ++i)
+		{
+			std::filesystem::file_time_type time = writeTime(m_paths[i]);
+			if (time != m_writeTimes[i])
+			{
+				m_writeTimes[i] = time;
+				changedPaths.push_back(m_paths[i]);
+			}
+		}
+		lock.lock();
+
+		for (std::string& path : changedPaths)
+		{
+			if (std::find(m_changedPaths.begin(), m_changedPaths.end(), path) ==
+				m_changedPaths.end())
+			{
+				m_changedPaths.push_back(std::move(path));
+			}
+		}
+	}
+}
+
+std::filesystem::file_time_type ShaderWatcher::writeTime(const std::string& path)
+{
+	std::error_code error{};
+	std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+	return error ? std::filesystem::file_time_type{} : time;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ShaderWatcher
+{
+public:
+	ShaderWatcher(const std::vector<std::string>& paths);
+	ShaderWatcher(const ShaderWatcher&) = delete;
+	ShaderWatcher(ShaderWatcher&&) = delete;
+	~ShaderWatcher();
+
+	ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+	ShaderWatcher& operator=(ShaderWatcher&&) = delete;
+
+	std::vector<std::string> takeChangedPaths();
+
+private:
+	static constexpr std::chrono::milliseconds pollInterval{250};
+
+	std::vector<std::string> m_paths{};
+	std::vector<std::filesystem::file_time_type> m_writeTimes{};
+	std::vector<std::string> m_changedPaths{};
+
+	std::mutex m_mutex{};
+	std::condition_variable m_stopCondition{};
+	bool m_stop = false;
+	std::thread m_thread{};
+
+	void watch();
+
+	static std::filesystem::file_time_type writeTime(const std::string& path);
+};
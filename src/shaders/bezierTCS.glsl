@@ -1,25 +1,104 @@
 #version 420 core
 
 #define controlVerticesCount 16
-#define meshDensity 16
+#define segmentLengthPx 12.0f
+#define flatnessTolerancePx 0.5f
 
 in vec3 inTessPos[];
 
+uniform mat4 projectionViewMatrix;
+uniform ivec2 viewportSize;
+uniform float minTessLevel;
+uniform float maxTessLevel;
+
 layout (vertices = controlVerticesCount) out;
 out vec3 tessPos[];
 
+int index(int ui, int vi);
+vec2 screenPos(vec4 clipPos);
+bool isOutsideFrustum(vec4 clipPos[controlVerticesCount]);
+float curveTessLevel(vec2 a, vec2 b, vec2 c, vec2 d);
+
 void main()
 {
 	tessPos[gl_InvocationID] = inTessPos[gl_InvocationID];
 
 	if (gl_InvocationID == 0)
 	{
-		gl_TessLevelInner[0] = meshDensity;
-		gl_TessLevelInner[1] = meshDensity;
+		vec4 clipPos[controlVerticesCount];
+		vec2 pos[controlVerticesCount];
+		for (int i = 0; i < controlVerticesCount; ++i)
+		{
+			clipPos[i] = projectionViewMatrix * vec4(inTessPos[i], 1);
+			pos[i] = screenPos(clipPos[i]);
+		}
+
+		if (isOutsideFrustum(clipPos))
+		{
+			gl_TessLevelOuter[0] = 0;
+			gl_TessLevelOuter[1] = 0;
+			gl_TessLevelOuter[2] = 0;
+			gl_TessLevelOuter[3] = 0;
+			return;
+		}
 
-		gl_TessLevelOuter[0] = meshDensity;
-		gl_TessLevelOuter[1] = meshDensity;
-		gl_TessLevelOuter[2] = meshDensity;
-		gl_TessLevelOuter[3] = meshDensity;
+		float tessLevelsU[4];
+		float tessLevelsV[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			tessLevelsU[i] = curveTessLevel(pos[index(0, i)], pos[index(1, i)], pos[index(2, i)],
+				pos[index(3, i)]);
+			tessLevelsV[i] = curveTessLevel(pos[index(i, 0)], pos[index(i, 1)], pos[index(i, 2)],
+				pos[index(i, 3)]);
+		}
+
+		gl_TessLevelOuter[0] = tessLevelsV[0];
+		gl_TessLevelOuter[1] = tessLevelsU[0];
+		gl_TessLevelOuter[2] = tessLevelsV[3];
+		gl_TessLevelOuter[3] = tessLevelsU[3];
+
+		gl_TessLevelInner[0] = max(max(tessLevelsU[0], tessLevelsU[1]),
+			max(tessLevelsU[2], tessLevelsU[3]));
+		gl_TessLevelInner[1] = max(max(tessLevelsV[0], tessLevelsV[1]),
+			max(tessLevelsV[2], tessLevelsV[3]));
 	}
 }
+
+int index(int ui, int vi)
+{
+	return 4 * vi + ui;
+}
+
+vec2 screenPos(vec4 clipPos)
+{
+	const float minW = 1e-3f;
+	return clipPos.xy / max(clipPos.w, minW) * 0.5f * vec2(viewportSize);
+}
+
+bool isOutsideFrustum(vec4 clipPos[controlVerticesCount])
+{
+	ivec3 belowCount = ivec3(0);
+	ivec3 aboveCount = ivec3(0);
+	for (int i = 0; i < controlVerticesCount; ++i)
+	{
+		belowCount += ivec3(lessThan(clipPos[i].xyz, vec3(-clipPos[i].w)));
+		aboveCount += ivec3(greaterThan(clipPos[i].xyz, vec3(clipPos[i].w)));
+	}
+	return any(equal(belowCount, ivec3(controlVerticesCount))) ||
+		any(equal(aboveCount, ivec3(controlVerticesCount)));
+}
+
+// Both the length and the flatness estimate are symmetric in the control points, so patches sharing
+// an edge (with reversed orientation) compute exactly the same outer level and no cracks appear.
+float curveTessLevel(vec2 a, vec2 b, vec2 c, vec2 d)
+{
+	float polygonLength = (distance(a, b) + distance(c, d)) + distance(b, c);
+	float sizeLevel = polygonLength / segmentLengthPx;
+
+	// Uniform subdivision of a cubic Bezier curve into n segments deviates from the curve by at
+	// most 3/4 * max|second difference| / n^2
+	float secondDifference = max(length((a + c) - 2 * b), length((b + d) - 2 * c));
+	float flatnessLevel = sqrt(0.75f * secondDifference / flatnessTolerancePx);
+
+	return clamp(ceil(max(sizeLevel, flatnessLevel)), minTessLevel, maxTessLevel);
+}
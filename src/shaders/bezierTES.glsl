@@ -1,7 +1,5 @@
 #version 420 core
 
-#define meshDensity 16
-
 layout (quads, equal_spacing, ccw) in;
 in vec3 tessPos[];
 
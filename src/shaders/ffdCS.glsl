@@ -0,0 +1,92 @@
+#version 430 core
+
+// Must match FFDMesh::deformGroupSize
+#define groupSize 64
+
+layout (local_size_x = groupSize) in;
+
+struct RestVertex
+{
+	vec4 basisU;
+	vec4 basisV;
+	vec4 basisW;
+	vec4 derivBasisU;
+	vec4 derivBasisV;
+	vec4 derivBasisW;
+	vec4 normalVector;
+};
+
+layout (std430, binding = 0) readonly buffer RestVertices
+{
+	RestVertex restVertices[];
+};
+
+// Laid out as Mesh::Vertex: position followed by normal vector, 6 tightly packed floats
+layout (std430, binding = 1) writeonly buffer Vertices
+{
+	float vertices[];
+};
+
+uniform vec3 bezierPoints[64];
+uniform int vertexCount;
+
+int index(int ui, int vi, int wi);
+
+void main()
+{
+	int vertexIndex = int(gl_GlobalInvocationID.x);
+	if (vertexIndex >= vertexCount)
+	{
+		return;
+	}
+	RestVertex restVertex = restVertices[vertexIndex];
+
+	vec3 pos = vec3(0);
+	vec3 jacobianU = vec3(0);
+	vec3 jacobianV = vec3(0);
+	vec3 jacobianW = vec3(0);
+	for (int wi = 0; wi < 4; ++wi)
+	{
+		for (int vi = 0; vi < 4; ++vi)
+		{
+			vec3 rowPos = vec3(0);
+			vec3 rowDerivU = vec3(0);
+			for (int ui = 0; ui < 4; ++ui)
+			{
+				vec3 bezierPoint = bezierPoints[index(ui, vi, wi)];
+				rowPos += restVertex.basisU[ui] * bezierPoint;
+				rowDerivU += restVertex.derivBasisU[ui] * bezierPoint;
+			}
+
+			float basisVW = restVertex.basisV[vi] * restVertex.basisW[wi];
+			pos += basisVW * rowPos;
+			jacobianU += basisVW * rowDerivU;
+			jacobianV += restVertex.derivBasisV[vi] * restVertex.basisW[wi] * rowPos;
+			jacobianW += restVertex.basisV[vi] * restVertex.derivBasisW[wi] * rowPos;
+		}
+	}
+
+	// inverse(transpose(jacobian)) is the cofactor matrix divided by the determinant, so only the
+	// determinant's sign is needed before normalizing
+	vec3 cofactorU = cross(jacobianV, jacobianW);
+	vec3 cofactorV = cross(jacobianW, jacobianU);
+	vec3 cofactorW = cross(jacobianU, jacobianV);
+	float determinantSign = dot(jacobianU, cofactorU) < 0 ? -1.0f : 1.0f;
+	vec3 normalVector = determinantSign * (restVertex.normalVector.x * cofactorU +
+		restVertex.normalVector.y * cofactorV + restVertex.normalVector.z * cofactorW);
+	float normalLength = length(normalVector);
+	normalVector = normalLength > 0 ? normalVector / normalLength : normalVector;
+
+	int offset = 6 * vertexIndex;
+	vertices[offset] = pos.x;
+	vertices[offset + 1] = pos.y;
+	vertices[offset + 2] = pos.z;
+	vertices[offset + 3] = normalVector.x;
+	vertices[offset + 4] = normalVector.y;
+	vertices[offset + 5] = normalVector.z;
+}
+
+int index(int ui, int vi, int wi)
+{
+	return 16 * wi + 4 * vi + ui;
+}
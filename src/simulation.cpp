@@ -1,11 +1,15 @@
 #include "simulation.hpp"
 
+#include "parallel.hpp"
+#include "profiler/cpuTimer.hpp"
 #include "rungeKutta.hpp"
 
 #include <glm/gtc/random.hpp>
 
 #include <algorithm>
 #include <cmath>
+#include <memory_resource>
+#include <span>
 
 Simulation::Simulation(const std::vector<std::unique_ptr<Model>>& massPointModels,
 	Model& bezierCubeModel, Model& internalSpringsModel, Model& controlCubeModel,
@@ -20,38 +24,56 @@ Simulation::Simulation(const std::vector<std::unique_ptr<Model>>& massPointModel
 		m_massPointModels.push_back(massPointModel.get());
 	}
 
+	m_controlCubeAnchors = m_anchors.add(ElasticCube::cornerIndices, m_controlCube.getCorners(),
+		m_externalStiffness, m_externalDamping);
+
 	start();
 	std::vector<glm::vec3> vertices = ElasticCube::createVertices(cubeSize);
 	std::copy(vertices.begin(), vertices.end(), m_state.poss.begin());
+	m_prevPoss = m_state.poss;
+	resetCheckpoints();
+
+	// Alternating neighbors, close to the stiffest mode of a lattice.
+	for (int i = 0; i < 64; ++i)
+	{
+		float sign = (i % 4 + i / 4 % 4 + i / 16) % 2 == 0 ? 1.0f : -1.0f;
+		m_stiffestMode[i] = sign * glm::vec3{1, 1, 1} / std::sqrt(3.0f * 64);
+	}
 }
 
-void Simulation::update()
+void Simulation::update(const ModelVisibility& visibility,
+	std::pmr::memory_resource* frameResource)
 {
-	if (!m_running)
+	if (m_isRecording &&
+		isOutdated(m_recordedControlCubeGeneration, m_controlCube.getGeneration()))
 	{
-		return;
+		recordControlCubePose();
 	}
 
-	float frameT = getSimulationTime();
-	int iterations = static_cast<int>(frameT / m_dT);
+	if (m_stableDTOutdated)
+	{
+		updateStableDT();
+	}
 
-	while (m_t.size() <= iterations)
+	float renderAlpha = 1;
+	if (m_running)
 	{
-		float prevT = (m_t.size() - 1) * m_dT;
-		float t = prevT + m_dT;
-		m_state = State{RungeKutta::RK4(prevT, m_dT, m_state.toArray(),
-			[this] (float, const RungeKutta::State& state)
-			{
-				return getRHS(state).toArray();
-			}
-		)};
-		processCollisions();
+		float frameT = getSimulationTime();
+		while (m_running && getStepT(m_t.size()) <= frameT)
+		{
+			step(m_t.back());
+			m_t.push_back(getStepT(m_t.size()));
+		}
 
-		m_t.push_back(t);
+		if (m_running && m_renderInterpolation && !m_asleep)
+		{
+			renderAlpha = std::clamp((frameT - m_t.back()) / m_dT, 0.0f, 1.0f);
+		}
 	}
 
-	updateElasticCube();
-	updateModels();
+	CPUTimer timer{Profiler::CPUSection::modelUpdates};
+	updateRenderState(renderAlpha);
+	updateModels(visibility, frameResource);
 }
 
 void Simulation::stop()
@@ -68,6 +90,10 @@ void Simulation::start()
 
 	m_t.clear();
 	m_t.push_back(0);
+	m_dTChangeT = 0;
+	m_dTChangeIteration = 0;
+	wake();
+	m_rolledBack = false;
 
 	resetTime();
 	m_running = true;
@@ -75,6 +101,8 @@ void Simulation::start()
 
 void Simulation::disturb()
 {
+	record(InputRecording::Input::disturb, {});
+	wake();
 	for (glm::vec3& velocity : m_state.velocities)
 	{
 		float randCoefficient = m_uniformDistribution(m_randomEngine);
@@ -89,6 +117,120 @@ void Simulation::disturb()
 	}
 }
 
+Simulation::ControlCubeTrajectory Simulation::getControlCubeTrajectory() const
+{
+	return m_controlCubeTrajectory;
+}
+
+void Simulation::setControlCubeTrajectory(ControlCubeTrajectory controlCubeTrajectory)
+{
+	selectTrajectory(controlCubeTrajectory);
+	m_trajectoryT = 0;
+	record(InputRecording::Input::trajectory, {static_cast<float>(controlCubeTrajectory), 0, 0});
+}
+
+void Simulation::selectTrajectory(ControlCubeTrajectory controlCubeTrajectory)
+{
+	m_controlCubeTrajectory = controlCubeTrajectory;
+	switch (controlCubeTrajectory)
+	{
+		case ControlCubeTrajectory::shake:
+			m_trajectory = Trajectory::shake();
+			break;
+
+		case ControlCubeTrajectory::orbit:
+			m_trajectory = Trajectory::orbit();
+			break;
+
+		default:
+			m_trajectory = std::nullopt;
+			break;
+	}
+}
+
+void Simulation::startRecording()
+{
+	m_isReplaying = false;
+
+	std::uint32_t seed = m_randomDevice();
+	m_recording = InputRecording{seed, m_state};
+	restart(m_state, seed);
+	m_isRecording = true;
+	m_recordingStartStep = m_step;
+	m_trajectoryT = 0;
+	recordSettings();
+	resetCheckpoints();
+}
+
+void Simulation::stopRecording()
+{
+	m_isRecording = false;
+}
+
+bool Simulation::isRecording() const
+{
+	return m_isRecording;
+}
+
+void Simulation::startReplay()
+{
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_isRecording = false;
+	restart(m_recording->getInitialState(), m_recording->getSeed());
+	m_isReplaying = true;
+	m_replayStartStep = m_step;
+	m_replayEvent = 0;
+	resetCheckpoints();
+}
+
+void Simulation::stopReplay()
+{
+	m_isReplaying = false;
+}
+
+bool Simulation::isReplaying() const
+{
+	return m_isReplaying;
+}
+
+const std::optional<InputRecording>& Simulation::getRecording() const
+{
+	return m_recording;
+}
+
+bool Simulation::saveRecording(const std::string& path) const
+{
+	return m_recording && m_recording->save(path);
+}
+
+bool Simulation::loadRecording(const std::string& path)
+{
+	std::optional<InputRecording> recording = InputRecording::load(path);
+	if (!recording)
+	{
+		return false;
+	}
+
+	m_isRecording = false;
+	m_isReplaying = false;
+	m_recording = std::move(recording);
+	return true;
+}
+
+float Simulation::Diagnostics::getPotentialEnergy() const
+{
+	return elasticEnergy + anchorEnergy + gravityEnergy;
+}
+
+float Simulation::Diagnostics::getTotalEnergy() const
+{
+	return kineticEnergy + getPotentialEnergy();
+}
+
 glm::mat3 Simulation::initialRotation()
 {
 	static constexpr float piOver4 = glm::pi<float>() * 0.25f;
@@ -120,12 +262,11 @@ float Simulation::getDT() const
 
 void Simulation::setDT(float dT)
 {
-	if (m_running)
-	{
-		return;
-	}
-
+	// Later steps are timed from the current one.
+	m_dTChangeT = getT();
+	m_dTChangeIteration = m_t.empty() ? 0 : m_t.size() - 1;
 	m_dT = dT;
+	record(InputRecording::Input::dT, {dT, 0, 0});
 }
 
 float Simulation::getMass() const
@@ -136,6 +277,9 @@ float Simulation::getMass() const
 void Simulation::setMass(float mass)
 {
 	m_mass = mass;
+	record(InputRecording::Input::mass, {mass, 0, 0});
+	m_stableDTOutdated = true;
+	wake();
 }
 
 float Simulation::getInternalStiffness() const
@@ -146,6 +290,9 @@ float Simulation::getInternalStiffness() const
 void Simulation::setInternalStiffness(float internalstiffness)
 {
 	m_internalStiffness = internalstiffness;
+	record(InputRecording::Input::internalStiffness, {internalstiffness, 0, 0});
+	m_stableDTOutdated = true;
+	wake();
 }
 
 float Simulation::getExternalStiffness() const
@@ -156,6 +303,24 @@ float Simulation::getExternalStiffness() const
 void Simulation::setExternalStiffness(float externalStiffness)
 {
 	m_externalStiffness = externalStiffness;
+	record(InputRecording::Input::externalStiffness, {externalStiffness, 0, 0});
+	updateControlCubeAnchorParameters();
+	m_stableDTOutdated = true;
+	wake();
+}
+
+float Simulation::getExternalDamping() const
+{
+	return m_externalDamping;
+}
+
+void Simulation::setExternalDamping(float externalDamping)
+{
+	m_externalDamping = externalDamping;
+	record(InputRecording::Input::externalDamping, {externalDamping, 0, 0});
+	updateControlCubeAnchorParameters();
+	m_stableDTOutdated = true;
+	wake();
 }
 
 float Simulation::getDamping() const
@@ -166,6 +331,90 @@ float Simulation::getDamping() const
 void Simulation::setDamping(float damping)
 {
 	m_damping = damping;
+	record(InputRecording::Input::damping, {damping, 0, 0});
+	m_stableDTOutdated = true;
+	wake();
+}
+
+Simulation::MaterialModel Simulation::getMaterialModel() const
+{
+	return m_materialModel;
+}
+
+void Simulation::setMaterialModel(MaterialModel materialModel)
+{
+	m_materialModel = materialModel;
+	record(InputRecording::Input::materialModel, {static_cast<float>(materialModel), 0, 0});
+	m_stableDTOutdated = true;
+	wake();
+}
+
+float Simulation::getYoungModulus() const
+{
+	return m_youngModulus;
+}
+
+void Simulation::setYoungModulus(float youngModulus)
+{
+	m_youngModulus = youngModulus;
+	record(InputRecording::Input::youngModulus, {youngModulus, 0, 0});
+	m_stableDTOutdated = true;
+	wake();
+}
+
+float Simulation::getPoissonRatio() const
+{
+	return m_poissonRatio;
+}
+
+void Simulation::setPoissonRatio(float poissonRatio)
+{
+	m_poissonRatio = poissonRatio;
+	record(InputRecording::Input::poissonRatio, {poissonRatio, 0, 0});
+	m_stableDTOutdated = true;
+	wake();
+}
+
+Simulation::Solver Simulation::getSolver() const
+{
+	return m_solver;
+}
+
+void Simulation::setSolver(Solver solver)
+{
+	m_solver = solver;
+	record(InputRecording::Input::solver, {static_cast<float>(solver), 0, 0});
+	m_stableDTOutdated = true;
+	wake();
+}
+
+int Simulation::getXPBDIterations() const
+{
+	return m_xpbdIterations;
+}
+
+void Simulation::setXPBDIterations(int xpbdIterations)
+{
+	m_xpbdIterations = xpbdIterations;
+	record(InputRecording::Input::xpbdIterations, {static_cast<float>(xpbdIterations), 0, 0});
+	wake();
+}
+
+int Simulation::getXPBDLevels() const
+{
+	return m_xpbdLevels;
+}
+
+void Simulation::setXPBDLevels(int xpbdLevels)
+{
+	m_xpbdLevels = xpbdLevels;
+	record(InputRecording::Input::xpbdLevels, {static_cast<float>(xpbdLevels), 0, 0});
+	wake();
+}
+
+int Simulation::getMaxXPBDLevels() const
+{
+	return static_cast<int>(m_topology.getCoarseLevels().size()) + 1;
 }
 
 float Simulation::getCollisionElasticity() const
@@ -176,6 +425,8 @@ float Simulation::getCollisionElasticity() const
 void Simulation::setCollisionElasticity(float collisionElasticity)
 {
 	m_collisionElasticity = collisionElasticity;
+	record(InputRecording::Input::collisionElasticity, {collisionElasticity, 0, 0});
+	wake();
 }
 
 float Simulation::getDisturbanceVelocity() const
@@ -186,6 +437,7 @@ float Simulation::getDisturbanceVelocity() const
 void Simulation::setDisturbanceVelocity(float disturbanceVelocity)
 {
 	m_disturbanceVelocity = disturbanceVelocity;
+	record(InputRecording::Input::disturbanceVelocity, {disturbanceVelocity, 0, 0});
 }
 
 bool Simulation::getExternalSprings() const
@@ -196,6 +448,10 @@ bool Simulation::getExternalSprings() const
 void Simulation::setExternalSprings(bool externalsprings)
 {
 	m_externalSprings = externalsprings;
+	record(InputRecording::Input::externalSprings, {static_cast<float>(externalsprings), 0, 0});
+	updateControlCubeAnchorParameters();
+	m_stableDTOutdated = true;
+	wake();
 }
 
 bool Simulation::getGravity() const
@@ -206,6 +462,66 @@ bool Simulation::getGravity() const
 void Simulation::setGravity(bool gravity)
 {
 	m_gravity = gravity;
+	record(InputRecording::Input::gravity, {static_cast<float>(gravity), 0, 0});
+	wake();
+}
+
+bool Simulation::getSleeping() const
+{
+	return m_sleeping;
+}
+
+void Simulation::setSleeping(bool sleeping)
+{
+	m_sleeping = sleeping;
+	record(InputRecording::Input::sleeping, {static_cast<float>(sleeping), 0, 0});
+	wake();
+}
+
+bool Simulation::isAsleep() const
+{
+	return m_asleep;
+}
+
+bool Simulation::getRenderInterpolation() const
+{
+	return m_renderInterpolation;
+}
+
+void Simulation::setRenderInterpolation(bool renderInterpolation)
+{
+	m_renderInterpolation = renderInterpolation;
+}
+
+bool Simulation::getInstabilityDetection() const
+{
+	return m_instabilityDetection;
+}
+
+void Simulation::setInstabilityDetection(bool instabilityDetection)
+{
+	m_instabilityDetection = instabilityDetection;
+}
+
+bool Simulation::isRolledBack() const
+{
+	return m_rolledBack;
+}
+
+float Simulation::getStableDT() const
+{
+	return m_stableDT;
+}
+
+bool Simulation::getAutomaticDT() const
+{
+	return m_automaticDT;
+}
+
+void Simulation::setAutomaticDT(bool automaticDT)
+{
+	m_automaticDT = automaticDT;
+	m_stableDTOutdated = true;
 }
 
 int Simulation::getIterations() const
@@ -213,6 +529,21 @@ int Simulation::getIterations() const
 	return static_cast<int>(m_t.size());
 }
 
+std::uint64_t Simulation::getStateGeneration() const
+{
+	return m_stateGeneration;
+}
+
+std::uint64_t Simulation::getRenderGeneration() const
+{
+	return m_renderGeneration;
+}
+
+const Simulation::Diagnostics& Simulation::getDiagnostics() const
+{
+	return m_diagnostics;
+}
+
 float Simulation::getT() const
 {
 	if (m_t.empty())
@@ -222,6 +553,11 @@ float Simulation::getT() const
 	return m_t.back();
 }
 
+const Arena& Simulation::getStepArena() const
+{
+	return m_stepArena;
+}
+
 ElasticCube& Simulation::getElasticCube()
 {
 	return m_elasticCube;
@@ -244,8 +580,15 @@ void Simulation::resetTime()
 	m_t0 = std::chrono::system_clock::now();
 }
 
-State Simulation::getRHS(const State& state) const
+float Simulation::getStepT(std::size_t iteration) const
 {
+	return m_dTChangeT + static_cast<float>(iteration - m_dTChangeIteration) * m_dT;
+}
+
+State Simulation::getRHS(const State& state, Diagnostics* diagnostics) const
+{
+	CPUTimer timer{Profiler::CPUSection::rhs};
+
 	State stateDerivative{};
 
 	for (int i = 0; i < 64; ++i)
@@ -253,18 +596,16 @@ State Simulation::getRHS(const State& state) const
 		stateDerivative.poss[i] = state.velocities[i];
 	}
 
-	std::vector<glm::vec3> internalSpringsForces = getInternalSpringsForces(state);
-	std::vector<glm::vec3> externalSpringsForces = getExternalSpringsForces(state);
-	std::vector<glm::vec3> dampingForces = getDampingForces(state);
-	std::vector<glm::vec3> gravityForces = getGravityForces();
+	float* elasticEnergy = diagnostics != nullptr ? &diagnostics->elasticEnergy : nullptr;
+	float* anchorEnergy = diagnostics != nullptr ? &diagnostics->anchorEnergy : nullptr;
+	std::pmr::vector<glm::vec3> internalForces = getInternalForces(state, elasticEnergy);
+	std::pmr::vector<glm::vec3> anchorForces = getAnchorForces(state, anchorEnergy);
+	std::pmr::vector<glm::vec3> dampingForces = getDampingForces(state, diagnostics);
+	std::pmr::vector<glm::vec3> gravityForces = getGravityForces();
 
 	for (int i = 0; i < 64; ++i)
 	{
-		glm::vec3 force = internalSpringsForces[i] + dampingForces[i];
-		if (m_externalSprings)
-		{
-			force += externalSpringsForces[i];
-		}
+		glm::vec3 force = internalForces[i] + anchorForces[i] + dampingForces[i];
 		if (m_gravity)
 		{
 			force += gravityForces[i];
@@ -275,63 +616,620 @@ State Simulation::getRHS(const State& state) const
 	return stateDerivative;
 }
 
+void Simulation::step(float t)
+{
+	m_prevPoss = m_state.poss;
+	m_prevControlCubePose = m_controlCube.getPose();
+
+	if (m_isReplaying)
+	{
+		applyReplayEvents();
+	}
+	if (m_step >= m_stableDTStep + stableDTInterval)
+	{
+		updateStableDT();
+	}
+	if (m_trajectory)
+	{
+		updateTrajectory();
+	}
+
+	if (m_controlCubeAnchorsReset)
+	{
+		m_anchors.resetTargets(m_controlCubeAnchors, m_controlCube.getCorners());
+		m_controlCubeAnchorsReset = false;
+	}
+	else
+	{
+		m_anchors.setTargets(m_controlCubeAnchors, m_controlCube.getCorners(), m_dT);
+	}
+	if (m_asleep && m_controlCube.getGeneration() != m_asleepControlCubeGeneration)
+	{
+		wake();
+	}
+
+	bool stepped = !m_asleep;
+	if (!m_asleep)
+	{
+		CPUTimer timer{Profiler::CPUSection::physicsStep};
+
+		m_stepArena.reset();
+		State prevState = m_state;
+		if (m_solver == Solver::xpbd)
+		{
+			stepXPBD();
+		}
+		else
+		{
+			stepRK4(t);
+		}
+		bool impact = processCollisions();
+		++m_stateGeneration;
+		updateSleep(prevState, impact);
+	}
+
+	++m_step;
+	if (m_isRecording)
+	{
+		m_recording->setStepCount(m_step - m_recordingStartStep);
+	}
+	if (m_isReplaying && m_step - m_replayStartStep >= m_recording->getStepCount())
+	{
+		m_isReplaying = false;
+	}
+
+	if (stepped && m_instabilityDetection)
+	{
+		checkStability();
+	}
+}
+
+void Simulation::stepRK4(float t)
+{
+	// The first stage evaluates the forces at the current state, which measures its diagnostics.
+	Diagnostics* diagnostics = &m_diagnostics;
+	m_state = State{RungeKutta::RK4(t, m_dT, m_state.toArray(),
+		[this, &diagnostics] (float, const RungeKutta::State& state)
+		{
+			State stateDerivative = getRHS(state, diagnostics);
+			diagnostics = nullptr;
+			return stateDerivative.toArray();
+		}
+	)};
+}
+
+void Simulation::stepXPBD()
+{
+	std::pmr::vector<glm::vec3> externalForces = getDampingForces(m_state, &m_diagnostics);
+	if (m_gravity)
+	{
+		std::pmr::vector<glm::vec3> gravityForces = getGravityForces();
+		for (int i = 0; i < 64; ++i)
+		{
+			externalForces[i] += gravityForces[i];
+		}
+	}
+	m_anchors.addDampingForces(m_state, externalForces);
+
+	XPBDSolver::Energies energies = m_xpbdSolver.step(m_state, m_dT, particleMass(),
+		m_internalStiffness, m_xpbdIterations, static_cast<std::size_t>(m_xpbdLevels),
+		externalForces, m_anchors, &m_stepArena);
+	m_diagnostics.elasticEnergy = energies.constraints;
+	m_diagnostics.anchorEnergy = energies.anchors;
+}
+
+void Simulation::updateSleep(const State& prevState, bool impact)
+{
+	float kineticEnergy = 0;
+	float maxForce = 0;
+	for (int i = 0; i < 64; ++i)
+	{
+		kineticEnergy += 0.5f * particleMass() *
+			glm::dot(m_state.velocities[i], m_state.velocities[i]);
+		if (!m_wallContacts[i])
+		{
+			maxForce = std::max(maxForce, particleMass() *
+				glm::length(m_state.velocities[i] - prevState.velocities[i]) / m_dT);
+		}
+	}
+
+	if (!m_sleeping || impact || kineticEnergy > sleepKineticEnergyPerMass * m_mass ||
+		maxForce > sleepForcePerMass * m_mass)
+	{
+		m_restTime = 0;
+		return;
+	}
+
+	m_restTime += m_dT;
+	if (m_restTime >= sleepDelay)
+	{
+		m_asleep = true;
+		m_asleepControlCubeGeneration = m_controlCube.getGeneration();
+		m_state.velocities.fill(glm::vec3{});
+	}
+}
+
+void Simulation::wake()
+{
+	m_asleep = false;
+	m_restTime = 0;
+}
+
+void Simulation::checkStability()
+{
+	float energy = getStabilityEnergy();
+	float energyFloor = getStabilityEnergyFloor();
+	if (!std::isfinite(m_diagnostics.getTotalEnergy()) ||
+		energy > maxCheckpointGrowth * (m_checkpoints[1].energy + energyFloor))
+	{
+		rollBack();
+		return;
+	}
+
+	// Its state passed, the step after it being the one measured.
+	if (m_checkpointPending)
+	{
+		std::swap(m_checkpoints[0], m_checkpoints[1]);
+		std::swap(m_checkpoints[1], m_pendingCheckpoint);
+		m_checkpointPending = false;
+	}
+
+	if (m_step < m_windowStep + stabilityWindow)
+	{
+		return;
+	}
+
+	m_growingWindows = energy > maxWindowGrowth * (m_windowEnergy + energyFloor) ?
+		m_growingWindows + 1 : 0;
+	m_windowEnergy = energy;
+	m_windowStep = m_step;
+	if (m_growingWindows >= maxGrowingWindows)
+	{
+		rollBack();
+		return;
+	}
+
+	if (m_growingWindows == 0 && m_step >= m_checkpointStep + checkpointInterval)
+	{
+		saveCheckpoint(m_pendingCheckpoint);
+		m_checkpointPending = true;
+		m_checkpointStep = m_step;
+	}
+}
+
+float Simulation::getStabilityEnergy() const
+{
+	// Gravity is left out, its zero is arbitrary and falling only converts it.
+	return m_diagnostics.kineticEnergy + m_diagnostics.elasticEnergy +
+		m_diagnostics.anchorEnergy;
+}
+
+float Simulation::getStabilityEnergyFloor() const
+{
+	return 0.5f * m_mass * m_disturbanceVelocity * m_disturbanceVelocity;
+}
+
+void Simulation::saveCheckpoint(Checkpoint& checkpoint) const
+{
+	checkpoint.state = m_state;
+	checkpoint.step = m_step;
+	checkpoint.controlCubeTrajectory = m_controlCubeTrajectory;
+	checkpoint.trajectoryT = m_trajectoryT;
+	checkpoint.controlCubePose = m_controlCube.getPose();
+	checkpoint.anchors = m_anchors;
+	checkpoint.controlCubeAnchorsReset = m_controlCubeAnchorsReset;
+	checkpoint.rotations = m_corotationalFEM.getRotations();
+	checkpoint.randomEngine = m_randomEngine;
+	checkpoint.uniformDistribution = m_uniformDistribution;
+	checkpoint.normalDistribution = m_normalDistribution;
+	checkpoint.restTime = m_restTime;
+	checkpoint.stableDTStep = m_stableDTStep;
+	checkpoint.recordedEventCount = m_recording ? m_recording->getEvents().size() : 0;
+	checkpoint.replayEvent = m_replayEvent;
+	checkpoint.energy = getStabilityEnergy();
+}
+
+void Simulation::loadCheckpoint(const Checkpoint& checkpoint)
+{
+	m_state = checkpoint.state;
+	m_prevPoss = m_state.poss;
+	++m_stateGeneration;
+	m_step = checkpoint.step;
+	selectTrajectory(checkpoint.controlCubeTrajectory);
+	m_trajectoryT = checkpoint.trajectoryT;
+	m_controlCube.setPose(checkpoint.controlCubePose);
+	m_prevControlCubePose = checkpoint.controlCubePose;
+	m_recordedControlCubeGeneration = m_controlCube.getGeneration();
+	// The parameters are kept, including those of the anchors.
+	m_anchors = checkpoint.anchors;
+	updateControlCubeAnchorParameters();
+	m_controlCubeAnchorsReset = checkpoint.controlCubeAnchorsReset;
+	m_corotationalFEM.setRotations(checkpoint.rotations);
+	m_randomEngine = checkpoint.randomEngine;
+	m_uniformDistribution = checkpoint.uniformDistribution;
+	m_normalDistribution = checkpoint.normalDistribution;
+	m_asleep = false;
+	m_restTime = checkpoint.restTime;
+	m_stableDTStep = checkpoint.stableDTStep;
+	m_replayEvent = checkpoint.replayEvent;
+
+	// Inputs after the checkpoint are dropped. The parameters they changed are recorded again,
+	// the rest of what they affected was restored.
+	if (m_isRecording)
+	{
+		m_recording->truncate(checkpoint.recordedEventCount, m_step - m_recordingStartStep);
+		recordParameters();
+	}
+}
+
+void Simulation::resetCheckpoints()
+{
+	saveCheckpoint(m_checkpoints[0]);
+	m_checkpoints[1] = m_checkpoints[0];
+	m_checkpointPending = false;
+	m_checkpointStep = m_step;
+	m_windowEnergy = 0;
+	m_windowStep = m_step;
+	m_growingWindows = 0;
+}
+
+void Simulation::rollBack()
+{
+	loadCheckpoint(m_checkpoints[0]);
+	resetCheckpoints();
+
+	stop();
+	m_rolledBack = true;
+}
+
+void Simulation::updateStableDT()
+{
+	m_stableDT = estimateStableDT();
+	m_stableDTOutdated = false;
+	m_stableDTStep = m_step;
+
+	// Changes made on a recording are recorded as time step inputs, so a replay keeps those.
+	if (m_automaticDT && !m_isReplaying && m_solver == Solver::rungeKutta4 &&
+		std::abs(m_stableDT - m_dT) > automaticDTTolerance * m_dT)
+	{
+		setDT(m_stableDT);
+	}
+}
+
+float Simulation::estimateStableDT()
+{
+	// Power iteration for the largest eigenvalue of the stiffness matrix, the squared highest
+	// natural frequency times the particle mass.
+	float eigenvalue = 0;
+	for (int i = 0; i < stableDTIterations; ++i)
+	{
+		m_stepArena.reset();
+		std::pmr::vector<glm::vec3> product = getStiffnessProduct(m_stiffestMode);
+		eigenvalue = 0;
+		float squaredNorm = 0;
+		for (int j = 0; j < 64; ++j)
+		{
+			eigenvalue += glm::dot(m_stiffestMode[j], product[j]);
+			squaredNorm += glm::dot(product[j], product[j]);
+		}
+		if (squaredNorm == 0)
+		{
+			break;
+		}
+		float norm = std::sqrt(squaredNorm);
+		for (int j = 0; j < 64; ++j)
+		{
+			m_stiffestMode[j] = product[j] / norm;
+		}
+	}
+
+	// The mode decays at the rate of the most damped points, the anchored ones. Overdamped, the
+	// faster of its two real eigenvalues can exceed the frequency.
+	float frequency = std::sqrt(std::max(eigenvalue, 0.0f) / particleMass());
+	float decayRate = (m_damping + m_anchors.getMaxDamping()) / (2 * particleMass());
+	float eigenvalueMagnitude = frequency;
+	if (decayRate > frequency)
+	{
+		eigenvalueMagnitude =
+			decayRate + std::sqrt(decayRate * decayRate - frequency * frequency);
+	}
+
+	if (eigenvalueMagnitude <= 0)
+	{
+		return maxAutomaticDT;
+	}
+	return std::min(stableDTSafetyFactor * rk4StabilityRadius / eigenvalueMagnitude,
+		maxAutomaticDT);
+}
+
+void Simulation::updateTrajectory()
+{
+	m_controlCube.setPose(m_trajectory->evaluate(m_trajectoryT));
+	m_trajectoryT += m_dT;
+	// Reproduced from the trajectory input on replay, so not recorded as pose changes.
+	m_recordedControlCubeGeneration = m_controlCube.getGeneration();
+}
+
+void Simulation::restart(const State& state, std::uint32_t seed)
+{
+	// Everything a step depends on besides the inputs, so that a run started from the same state
+	// and seed evolves identically.
+	m_state = state;
+	m_prevPoss = state.poss;
+	++m_stateGeneration;
+	m_randomEngine.seed(seed);
+	m_uniformDistribution.reset();
+	m_normalDistribution.reset();
+	m_corotationalFEM.resetRotations();
+	m_controlCubeAnchorsReset = true;
+
+	m_running = false;
+	start();
+}
+
+void Simulation::record(InputRecording::Input input, const glm::vec3& value)
+{
+	if (m_isRecording)
+	{
+		m_recording->addEvent({m_step - m_recordingStartStep, input, value});
+	}
+}
+
+void Simulation::recordSettings()
+{
+	recordParameters();
+	record(InputRecording::Input::trajectory,
+		{static_cast<float>(m_controlCubeTrajectory), 0, 0});
+	m_recordedControlCubeGeneration = m_controlCube.getGeneration();
+	recordControlCubePose();
+}
+
+void Simulation::recordParameters()
+{
+	using Input = InputRecording::Input;
+	record(Input::dT, {m_dT, 0, 0});
+	record(Input::mass, {m_mass, 0, 0});
+	record(Input::internalStiffness, {m_internalStiffness, 0, 0});
+	record(Input::externalStiffness, {m_externalStiffness, 0, 0});
+	record(Input::externalDamping, {m_externalDamping, 0, 0});
+	record(Input::damping, {m_damping, 0, 0});
+	record(Input::materialModel, {static_cast<float>(m_materialModel), 0, 0});
+	record(Input::youngModulus, {m_youngModulus, 0, 0});
+	record(Input::poissonRatio, {m_poissonRatio, 0, 0});
+	record(Input::solver, {static_cast<float>(m_solver), 0, 0});
+	record(Input::xpbdIterations, {static_cast<float>(m_xpbdIterations), 0, 0});
+	record(Input::xpbdLevels, {static_cast<float>(m_xpbdLevels), 0, 0});
+	record(Input::collisionElasticity, {m_collisionElasticity, 0, 0});
+	record(Input::disturbanceVelocity, {m_disturbanceVelocity, 0, 0});
+	record(Input::externalSprings, {static_cast<float>(m_externalSprings), 0, 0});
+	record(Input::gravity, {static_cast<float>(m_gravity), 0, 0});
+	record(Input::sleeping, {static_cast<float>(m_sleeping), 0, 0});
+}
+
+void Simulation::recordControlCubePose()
+{
+	record(InputRecording::Input::controlCubePos, m_controlCube.getPos());
+	record(InputRecording::Input::controlCubeAngles, m_controlCube.getAnglesRad());
+}
+
+void Simulation::applyReplayEvents()
+{
+	const std::vector<InputRecording::Event>& events = m_recording->getEvents();
+	std::uint64_t replayStep = m_step - m_replayStartStep;
+	while (m_replayEvent < events.size() && events[m_replayEvent].step <= replayStep)
+	{
+		applyEvent(events[m_replayEvent]);
+		++m_replayEvent;
+	}
+}
+
+void Simulation::applyEvent(const InputRecording::Event& event)
+{
+	using Input = InputRecording::Input;
+	float value = event.value.x;
+	switch (event.input)
+	{
+		case Input::dT:
+			setDT(value);
+			break;
+
+		case Input::mass:
+			setMass(value);
+			break;
+
+		case Input::internalStiffness:
+			setInternalStiffness(value);
+			break;
+
+		case Input::externalStiffness:
+			setExternalStiffness(value);
+			break;
+
+		case Input::externalDamping:
+			setExternalDamping(value);
+			break;
+
+		case Input::damping:
+			setDamping(value);
+			break;
+
+		case Input::materialModel:
+			setMaterialModel(static_cast<MaterialModel>(value));
+			break;
+
+		case Input::youngModulus:
+			setYoungModulus(value);
+			break;
+
+		case Input::poissonRatio:
+			setPoissonRatio(value);
+			break;
+
+		case Input::solver:
+			setSolver(static_cast<Solver>(value));
+			break;
+
+		case Input::xpbdIterations:
+			setXPBDIterations(static_cast<int>(value));
+			break;
+
+		case Input::xpbdLevels:
+			setXPBDLevels(static_cast<int>(value));
+			break;
+
+		case Input::collisionElasticity:
+			setCollisionElasticity(value);
+			break;
+
+		case Input::disturbanceVelocity:
+			setDisturbanceVelocity(value);
+			break;
+
+		case Input::externalSprings:
+			setExternalSprings(value != 0);
+			break;
+
+		case Input::gravity:
+			setGravity(value != 0);
+			break;
+
+		case Input::sleeping:
+			setSleeping(value != 0);
+			break;
+
+		case Input::trajectory:
+			setControlCubeTrajectory(static_cast<ControlCubeTrajectory>(value));
+			break;
+
+		case Input::controlCubePos:
+			m_controlCube.setPos(event.value);
+			break;
+
+		case Input::controlCubeAngles:
+			m_controlCube.setAnglesRad(event.value);
+			break;
+
+		case Input::disturb:
+			disturb();
+			break;
+
+		default:
+			break;
+	}
+}
+
+void Simulation::updateRenderState(float renderAlpha)
+{
+	bool isAlphaOutdated = renderAlpha != m_renderAlpha;
+	m_renderAlpha = renderAlpha;
+
+	bool isStateOutdated = isOutdated(m_elasticCubeGeneration, m_stateGeneration);
+	if (isStateOutdated || isAlphaOutdated)
+	{
+		updateElasticCube();
+		++m_renderGeneration;
+	}
+
+	bool isControlCubeOutdated = isOutdated(m_renderedControlCubeGeneration,
+		m_controlCube.getGeneration());
+	if (isControlCubeOutdated || isAlphaOutdated)
+	{
+		m_renderedControlCube.setPose(Frame::interpolate(m_prevControlCubePose,
+			m_controlCube.getPose(), m_renderAlpha));
+	}
+}
+
 void Simulation::updateElasticCube()
 {
-	std::vector<glm::vec3> vertices(64);
-	std::copy(m_state.poss.begin(), m_state.poss.end(), vertices.begin());
-	m_elasticCube.setVertices(vertices);
+	if (m_renderAlpha == 1)
+	{
+		m_elasticCube.setVertices(m_state.poss);
+		return;
+	}
+
+	std::array<glm::vec3, 64> poss{};
+	for (std::size_t i = 0; i < poss.size(); ++i)
+	{
+		poss[i] = glm::mix(m_prevPoss[i], m_state.poss[i], m_renderAlpha);
+	}
+	m_elasticCube.setVertices(poss);
 }
 
-void Simulation::updateModels() const
+void Simulation::updateModels(const ModelVisibility& visibility,
+	std::pmr::memory_resource* frameResource)
 {
-	updateMassPointModels();
-	updateBezierCubeModel();
-	updateInternalSpringsModel();
-	updateControlCubeModel();
-	updateExternalSpringsModel();
+	if (visibility.massPoints && isOutdated(m_massPointModelsGeneration, m_renderGeneration))
+	{
+		updateMassPointModels();
+	}
+	if (visibility.bezierCube && isOutdated(m_bezierCubeModelGeneration, m_renderGeneration))
+	{
+		updateBezierCubeModel(frameResource);
+	}
+	if (visibility.internalSprings &&
+		isOutdated(m_internalSpringsModelGeneration, m_renderGeneration))
+	{
+		updateInternalSpringsModel(frameResource);
+	}
+	if (visibility.controlCube &&
+		isOutdated(m_controlCubeModelGeneration, m_renderedControlCube.getGeneration()))
+	{
+		updateControlCubeModel();
+	}
+	if (visibility.externalSprings)
+	{
+		bool isStateOutdated = isOutdated(m_externalSpringsModelStateGeneration,
+			m_renderGeneration);
+		bool isControlCubeOutdated = isOutdated(m_externalSpringsModelControlCubeGeneration,
+			m_renderedControlCube.getGeneration());
+		if (isStateOutdated || isControlCubeOutdated)
+		{
+			updateExternalSpringsModel(frameResource);
+		}
+	}
 }
 
 void Simulation::updateMassPointModels() const
 {
-	std::vector<glm::vec3> vertices = m_elasticCube.getVertices();
-	for (int i = 0; i < 64; ++i)
+	std::span<const glm::vec3> vertices = m_elasticCube.getVertices();
+	for (std::size_t i = 0; i < vertices.size(); ++i)
 	{
 		m_massPointModels[i]->setPos(vertices[i]);
 	}
 }
 
-void Simulation::updateBezierCubeModel() const
+void Simulation::updateBezierCubeModel(std::pmr::memory_resource* frameResource) const
 {
-	std::vector<Mesh::Vertex> vertices{};
+	std::pmr::vector<Mesh::Vertex> vertices(frameResource);
+	vertices.reserve(m_elasticCube.getVertices().size());
 	for (const glm::vec3& vertexPos : m_elasticCube.getVertices())
 	{
 		vertices.push_back({vertexPos, {}});
 	}
-	m_bezierCubeModel.updateMesh(std::move(vertices));
+	m_bezierCubeModel.updateMesh(vertices);
 }
 
-void Simulation::updateInternalSpringsModel() const
+void Simulation::updateInternalSpringsModel(std::pmr::memory_resource* frameResource) const
 {
-	std::vector<Mesh::Vertex> vertices{};
+	std::pmr::vector<Mesh::Vertex> vertices(frameResource);
+	vertices.reserve(m_elasticCube.getVertices().size());
 	for (const glm::vec3& vertexPos : m_elasticCube.getVertices())
 	{
 		vertices.push_back({vertexPos, {}});
 	}
-	m_internalSpringsModel.updateMesh(std::move(vertices));
+	m_internalSpringsModel.updateMesh(vertices);
 }
 
 void Simulation::updateControlCubeModel() const
 {
-	m_controlCubeModel.setPos(m_controlCube.getPos());
-	m_controlCubeModel.setPitchRad(m_controlCube.getPitchRad());
-	m_controlCubeModel.setYawRad(m_controlCube.getYawRad());
-	m_controlCubeModel.setRollRad(m_controlCube.getRollRad());
+	m_controlCubeModel.setPose(m_renderedControlCube.getPose());
 }
 
-void Simulation::updateExternalSpringsModel() const
+void Simulation::updateExternalSpringsModel(std::pmr::memory_resource* frameResource) const
 {
-	std::vector<Mesh::Vertex> vertices{};
-	for (const glm::vec3& vertexPos : m_controlCube.getCorners())
+	std::pmr::vector<Mesh::Vertex> vertices(frameResource);
+	vertices.reserve(m_renderedControlCube.getCorners().size() + m_elasticCube.getCorners().size());
+	for (const glm::vec3& vertexPos : m_renderedControlCube.getCorners())
 	{
 		vertices.push_back({vertexPos, {}});
 	}
@@ -339,93 +1237,208 @@ void Simulation::updateExternalSpringsModel() const
 	{
 		vertices.push_back({vertexPos, {}});
 	}
-	m_externalSpringsModel.updateMesh(std::move(vertices));
+	m_externalSpringsModel.updateMesh(vertices);
 }
 
-std::vector<glm::vec3> Simulation::getInternalSpringsForces(const State& state) const
+std::pmr::vector<glm::vec3> Simulation::getInternalForces(const State& state, float* energy) const
 {
-	std::vector<glm::vec3> forces(64);
-	static const std::vector<glm::vec3> referenceVertices = ElasticCube::createVertices(cubeSize);
-	for (const std::pair<std::size_t, std::size_t>& spring : m_elasticCube.createSprings())
+	if (m_materialModel == MaterialModel::corotationalFEM)
 	{
-		float equilibriumLength = glm::length(referenceVertices[spring.second] -
-			referenceVertices[spring.first]);
-		glm::vec3 springVector = state.poss[spring.second] - state.poss[spring.first];
-		glm::vec3 springDirection = glm::normalize(springVector);
-		float displacement = glm::length(springVector) - equilibriumLength;
-		glm::vec3 force = m_internalStiffness * displacement * springDirection;
-		forces[spring.first] += force;
-		forces[spring.second] -= force;
+		return m_corotationalFEM.getForces(state, m_youngModulus, m_poissonRatio, &m_stepArena,
+			energy);
 	}
-	return forces;
+	return getInternalSpringsForces(state, energy);
+}
+
+std::pmr::vector<glm::vec3> Simulation::getInternalSpringsForces(const State& state,
+	float* energy) const
+{
+	const std::vector<LatticeTopology::Spring>& springs = m_topology.getSprings();
+	const std::vector<float>& restLengths = m_topology.getSpringRestLengths();
+	std::pmr::vector<glm::vec3> slotForces(2 * springs.size(), &m_stepArena);
+	auto evaluateSprings =
+		[this, &springs, &restLengths, &state, &slotForces] (std::size_t begin, std::size_t end)
+		{
+			float springEnergy = 0;
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				glm::vec3 springVector = state.poss[springs[i][1]] - state.poss[springs[i][0]];
+				float length = glm::length(springVector);
+				float displacement = length - restLengths[i];
+				glm::vec3 force = m_internalStiffness * displacement / length * springVector;
+				slotForces[2 * i] = force;
+				slotForces[2 * i + 1] = -force;
+				springEnergy += 0.5f * m_internalStiffness * displacement * displacement;
+			}
+			return springEnergy;
+		};
+
+	if (energy != nullptr)
+	{
+		*energy = Parallel::sumRanges(springs.size(), springGrainSize, evaluateSprings);
+	}
+	else
+	{
+		Parallel::forRange(springs.size(), springGrainSize, evaluateSprings);
+	}
+	return m_topology.getSpringGatherList().gather(slotForces, &m_stepArena);
 }
 
-std::vector<glm::vec3> Simulation::getExternalSpringsForces(const State& state) const
+std::pmr::vector<glm::vec3> Simulation::getAnchorForces(const State& state, float* energy) const
 {
-	std::vector<glm::vec3> forces(64);
-	std::vector<glm::vec3> controlCubeCorners = m_controlCube.getCorners();
-	std::vector<std::size_t> cornerIndices = ElasticCube::cornerIndices();
-	for (int i = 0; i < 8; ++i)
+	std::pmr::vector<glm::vec3> forces(64, &m_stepArena);
+	float anchorEnergy = m_anchors.addForces(state, forces);
+	if (energy != nullptr)
 	{
-		glm::vec3 springVector = controlCubeCorners[i] - state.poss[cornerIndices[i]];
-		forces[cornerIndices[i]] += m_externalStiffness * springVector;
+		*energy = anchorEnergy;
 	}
 	return forces;
 }
 
-std::vector<glm::vec3> Simulation::getDampingForces(const State& state) const
+std::pmr::vector<glm::vec3> Simulation::getDampingForces(const State& state,
+	Diagnostics* diagnostics) const
 {
-	std::vector<glm::vec3> forces(64);
+	std::pmr::vector<glm::vec3> forces(64, &m_stepArena);
+	float squaredSpeedSum = 0;
+	float heightSum = 0;
+	glm::vec3 velocitySum{};
 	for (int i = 0; i < 64; ++i)
 	{
 		forces[i] = -m_damping * state.velocities[i];
+		squaredSpeedSum += glm::dot(state.velocities[i], state.velocities[i]);
+		heightSum += state.poss[i].y + constraintBoxSize.y / 2;
+		velocitySum += state.velocities[i];
+	}
+
+	if (diagnostics != nullptr)
+	{
+		diagnostics->kineticEnergy = 0.5f * particleMass() * squaredSpeedSum;
+		diagnostics->gravityEnergy = m_gravity ?
+			gravityAcceleration * particleMass() * heightSum : 0;
+		diagnostics->momentum = particleMass() * velocitySum;
 	}
 	return forces;
 }
 
-std::vector<glm::vec3> Simulation::getGravityForces() const
+std::pmr::vector<glm::vec3> Simulation::getGravityForces() const
 {
-	return std::vector<glm::vec3>(64, glm::vec3{0, -9.81f * particleMass(), 0});
+	return std::pmr::vector<glm::vec3>(64,
+		glm::vec3{0, -gravityAcceleration * particleMass(), 0}, &m_stepArena);
+}
+
+std::pmr::vector<glm::vec3> Simulation::getStiffnessProduct(
+	std::span<const glm::vec3> direction) const
+{
+	std::pmr::vector<glm::vec3> product = m_materialModel == MaterialModel::corotationalFEM ?
+		m_corotationalFEM.getStiffnessProduct(direction, m_youngModulus, m_poissonRatio,
+			&m_stepArena) :
+		getInternalSpringsStiffnessProduct(m_state, direction);
+	m_anchors.addStiffnessProduct(direction, product);
+	return product;
+}
+
+std::pmr::vector<glm::vec3> Simulation::getInternalSpringsStiffnessProduct(const State& state,
+	std::span<const glm::vec3> direction) const
+{
+	const std::vector<LatticeTopology::Spring>& springs = m_topology.getSprings();
+	const std::vector<float>& restLengths = m_topology.getSpringRestLengths();
+	std::pmr::vector<glm::vec3> slotProducts(2 * springs.size(), &m_stepArena);
+	Parallel::forRange(springs.size(), springGrainSize,
+		[this, &springs, &restLengths, &state, direction, &slotProducts]
+		(std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				glm::vec3 springVector = state.poss[springs[i][1]] - state.poss[springs[i][0]];
+				float length = glm::length(springVector);
+				glm::vec3 axis = springVector / length;
+				glm::vec3 relative = direction[springs[i][1]] - direction[springs[i][0]];
+				glm::vec3 axial = glm::dot(axis, relative) * axis;
+				// Stretched springs also resist transverse motion. Compressed ones would soften
+				// it, left out to keep the matrix positive semidefinite.
+				float transverse = std::max(1 - restLengths[i] / length, 0.0f);
+				glm::vec3 product = m_internalStiffness * (axial + transverse * (relative - axial));
+				slotProducts[2 * i] = -product;
+				slotProducts[2 * i + 1] = product;
+			}
+		}
+	);
+	return m_topology.getSpringGatherList().gather(slotProducts, &m_stepArena);
 }
 
-void Simulation::processCollisions()
+bool Simulation::processCollisions()
 {
+	CPUTimer timer{Profiler::CPUSection::collisions};
+
+	bool anyImpact = false;
 	for (int i = 0; i < 64; ++i)
 	{
+		glm::vec3& pos = m_state.poss[i];
+		glm::vec3& velocity = m_state.velocities[i];
+		m_wallContacts[i] = false;
 		bool collision = true;
 		while (collision)
 		{
+			std::array<Contact, 6> contacts{
+				processCollision(false, -constraintBoxSize.x / 2, pos.x, velocity.x),
+				processCollision(true, constraintBoxSize.x / 2, pos.x, velocity.x),
+				processCollision(false, -constraintBoxSize.y / 2, pos.y, velocity.y),
+				processCollision(true, constraintBoxSize.y / 2, pos.y, velocity.y),
+				processCollision(false, -constraintBoxSize.z / 2, pos.z, velocity.z),
+				processCollision(true, constraintBoxSize.z / 2, pos.z, velocity.z)
+			};
 			collision = false;
-			collision |= processCollision(false, -constraintBoxSize.x / 2, m_state.poss[i].x,
-				m_state.velocities[i].x);
-			collision |= processCollision(true, constraintBoxSize.x / 2, m_state.poss[i].x,
-				m_state.velocities[i].x);
-			collision |= processCollision(false, -constraintBoxSize.y / 2, m_state.poss[i].y,
-				m_state.velocities[i].y);
-			collision |= processCollision(true, constraintBoxSize.y / 2, m_state.poss[i].y,
-				m_state.velocities[i].y);
-			collision |= processCollision(false, -constraintBoxSize.z / 2, m_state.poss[i].z,
-				m_state.velocities[i].z);
-			collision |= processCollision(true, constraintBoxSize.z / 2, m_state.poss[i].z,
-				m_state.velocities[i].z);
+			for (Contact contact : contacts)
+			{
+				collision |= contact != Contact::none;
+				m_wallContacts[i] |= contact == Contact::resting;
+				anyImpact |= contact == Contact::impact;
+			}
 		}
 	}
+	return anyImpact;
 }
 
-bool Simulation::processCollision(bool isWallPositive, float wallPos, float& particlePos,
-	float& particleVelocity) const
+Simulation::Contact Simulation::processCollision(bool isWallPositive, float wallPos,
+	float& particlePos, float& particleVelocity) const
 {
 	float wallDistance = particlePos - wallPos;
 	if (isWallPositive ? wallDistance > 0 : wallDistance < 0)
 	{
+		if (std::abs(particleVelocity) < restingContactSpeed)
+		{
+			particlePos = wallPos;
+			particleVelocity = 0;
+			return Contact::resting;
+		}
 		particlePos = wallPos - m_collisionElasticity * wallDistance;
 		particleVelocity *= -m_collisionElasticity;
-		return true;
+		return Contact::impact;
 	}
-	return false;
+	return Contact::none;
+}
+
+void Simulation::updateControlCubeAnchorParameters()
+{
+	// Disabled anchors are kept with zero stiffness and damping so that the range stays valid.
+	std::size_t count = ElasticCube::cornerIndices.size();
+	float stiffness = m_externalSprings ? m_externalStiffness : 0;
+	float damping = m_externalSprings ? m_externalDamping : 0;
+	m_anchors.setStiffness(m_controlCubeAnchors, count, stiffness);
+	m_anchors.setDamping(m_controlCubeAnchors, count, damping);
 }
 
 float Simulation::particleMass() const
 {
 	return m_mass / 64;
 }
+
+bool Simulation::isOutdated(std::uint64_t& builtGeneration, std::uint64_t generation)
+{
+	if (builtGeneration == generation)
+	{
+		return false;
+	}
+	builtGeneration = generation;
+	return true;
+}
@@ -1,32 +1,107 @@
 #pragma once
 
+#include "anchors.hpp"
+#include "arena.hpp"
 #include "controlCube.hpp"
+#include "corotationalFEM.hpp"
 #include "elasticCube.hpp"
+#include "inputRecording.hpp"
+#include "latticeTopology.hpp"
 #include "model.hpp"
 #include "state.hpp"
+#include "trajectory.hpp"
+#include "xpbdSolver.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <chrono>
 #include <functional>
+#include <memory_resource>
+#include <optional>
 #include <random>
+#include <span>
+#include <string>
 #include <vector>
 
 class Simulation
 {
 public:
+	enum class MaterialModel
+	{
+		springs,
+		corotationalFEM
+	};
+
+	enum class Solver
+	{
+		rungeKutta4,
+		xpbd
+	};
+
+	enum class ControlCubeTrajectory
+	{
+		none,
+		shake,
+		orbit
+	};
+
 	static constexpr glm::vec3 constraintBoxSize{10.0f, 5.0f, 5.0f};
 	static constexpr glm::vec3 cubeSize{1, 1, 1};
+	static constexpr std::uint64_t noGeneration = ~std::uint64_t{};
+
+	// Energies and momentum of the state a step started from, measured by its force evaluation.
+	struct Diagnostics
+	{
+		float kineticEnergy = 0;
+		// Of the internal springs or finite elements.
+		float elasticEnergy = 0;
+		float anchorEnergy = 0;
+		// Relative to the floor of the constraint box, zero without gravity.
+		float gravityEnergy = 0;
+		glm::vec3 momentum{};
+
+		float getPotentialEnergy() const;
+		float getTotalEnergy() const;
+	};
+
+	// Models that are currently rendered; hidden ones are not updated.
+	struct ModelVisibility
+	{
+		bool massPoints = true;
+		bool bezierCube = true;
+		bool internalSprings = true;
+		bool controlCube = true;
+		bool externalSprings = true;
+	};
 
 	Simulation(const std::vector<std::unique_ptr<Model>>& massPointModels, Model& bezierCubeModel,
 		Model& internalSpringsModel, Model& controlCubeModel, Model& externalSpringsModel);
-	void update();
+	// Scratch data of the model updates is allocated from frameResource.
+	void update(const ModelVisibility& visibility, std::pmr::memory_resource* frameResource);
 	void stop();
 	void start();
 	void disturb();
 
+	// The trajectory drives the control cube from the step it was selected at, in simulation time.
+	ControlCubeTrajectory getControlCubeTrajectory() const;
+	void setControlCubeTrajectory(ControlCubeTrajectory controlCubeTrajectory);
+
+	// Recording restarts the simulation from its current state and records every input from then
+	// on. Replay restarts it from the recorded state and applies the inputs at their steps.
+	void startRecording();
+	void stopRecording();
+	bool isRecording() const;
+	void startReplay();
+	void stopReplay();
+	bool isReplaying() const;
+	const std::optional<InputRecording>& getRecording() const;
+	bool saveRecording(const std::string& path) const;
+	bool loadRecording(const std::string& path);
+
 	static glm::mat3 initialRotation();
 
 	float getDT() const;
@@ -37,8 +112,23 @@ public:
 	void setInternalStiffness(float internalStiffness);
 	float getExternalStiffness() const;
 	void setExternalStiffness(float externalStiffness);
+	float getExternalDamping() const;
+	void setExternalDamping(float externalDamping);
 	float getDamping() const;
 	void setDamping(float damping);
+	MaterialModel getMaterialModel() const;
+	void setMaterialModel(MaterialModel materialModel);
+	float getYoungModulus() const;
+	void setYoungModulus(float youngModulus);
+	float getPoissonRatio() const;
+	void setPoissonRatio(float poissonRatio);
+	Solver getSolver() const;
+	void setSolver(Solver solver);
+	int getXPBDIterations() const;
+	void setXPBDIterations(int xpbdIterations);
+	int getXPBDLevels() const;
+	void setXPBDLevels(int xpbdLevels);
+	int getMaxXPBDLevels() const;
 	float getCollisionElasticity() const;
 	void setCollisionElasticity(float collisionElasticity);
 	float getDisturbanceVelocity() const;
@@ -47,30 +137,197 @@ public:
 	void setExternalSprings(bool externalSprings);
 	bool getGravity() const;
 	void setGravity(bool gravity);
+	bool getSleeping() const;
+	void setSleeping(bool sleeping);
+	bool isAsleep() const;
+	// Stops the simulation and rolls it back to a checkpoint once it becomes unstable.
+	bool getInstabilityDetection() const;
+	void setInstabilityDetection(bool instabilityDetection);
+	// Whether the simulation was rolled back since it was last started.
+	bool isRolledBack() const;
+	// Renders the state between the last two steps instead of the last one.
+	bool getRenderInterpolation() const;
+	void setRenderInterpolation(bool renderInterpolation);
+	// Largest time step Runge-Kutta 4 is stable at, estimated from the highest natural frequency
+	// of the lattice. Follows parameter changes and is refreshed periodically while running.
+	float getStableDT() const;
+	// Keeps the time step at the stable estimate while Runge-Kutta 4 is the solver.
+	bool getAutomaticDT() const;
+	void setAutomaticDT(bool automaticDT);
 
 	int getIterations() const;
 	float getT() const;
+	// Incremented whenever the mass point positions change.
+	std::uint64_t getStateGeneration() const;
+	// Incremented whenever the rendered mass point positions, those of the elastic cube, change.
+	std::uint64_t getRenderGeneration() const;
+
+	const Diagnostics& getDiagnostics() const;
+
+	// Scratch memory of the physics steps, reset before every step.
+	const Arena& getStepArena() const;
 
 	ElasticCube& getElasticCube();
 	ControlCube& getControlCube();
 
 private:
+	friend class SimulationBenchmarks;
+
 	bool m_running = false;
 
 	float m_dT = 0.005f;
 	float m_mass = 1.0f;
 	float m_internalStiffness = 50.0f;
 	float m_externalStiffness = 10.0f;
+	float m_externalDamping = 0.0f;
 	float m_damping = 0.03f;
+	MaterialModel m_materialModel = MaterialModel::springs;
+	float m_youngModulus = 150.0f;
+	float m_poissonRatio = 0.3f;
+	Solver m_solver = Solver::rungeKutta4;
+	int m_xpbdIterations = 10;
+	int m_xpbdLevels = 1;
 	float m_collisionElasticity = 0.7f;
 	float m_disturbanceVelocity = 10.0f;
 	bool m_externalSprings = true;
 	bool m_gravity = false;
+	bool m_sleeping = true;
+	bool m_renderInterpolation = true;
+	bool m_instabilityDetection = true;
+	bool m_automaticDT = false;
+
+	// The body falls asleep after staying below both thresholds for sleepDelay seconds. Points
+	// resting against a wall are left out of the force, which the wall balances.
+	static constexpr float sleepKineticEnergyPerMass = 1e-6f;
+	static constexpr float sleepForcePerMass = 1e-2f;
+	static constexpr float sleepDelay = 0.5f;
+
+	bool m_asleep = false;
+	float m_restTime = 0;
+	std::uint64_t m_asleepControlCubeGeneration = noGeneration;
+	std::array<bool, 64> m_wallContacts{};
+
+	static constexpr float gravityAcceleration = 9.81f;
+
+	// A point moving into a wall slower than restingContactSpeed is held against it rather than
+	// hitting it. It stops instead of bouncing off, which would keep the points supporting the
+	// body chattering on the floor, and does not wake the body.
+	static constexpr float restingContactSpeed = 1.0f;
+
+	enum class Contact
+	{
+		none,
+		resting,
+		impact
+	};
+
+	// The energy of motion and deformation is compared to that of the last checkpoint every step
+	// and to its value stabilityWindow steps earlier every stabilityWindow steps. The state
+	// counts as unstable once its energy is not finite, once it exceeds maxCheckpointGrowth times
+	// that of the checkpoint, or once it grew by more than maxWindowGrowth in maxGrowingWindows
+	// consecutive windows: sustained exponential growth, which drags and disturbances do not
+	// cause. Both are measured above the energy of a full disturbance, so that starting from rest
+	// is not growth. Checkpoints are taken checkpointInterval steps apart while the energy is not
+	// growing, and rolling back restores the older of the last two.
+	static constexpr float maxCheckpointGrowth = 1000.0f;
+	static constexpr std::uint64_t stabilityWindow = 50;
+	static constexpr float maxWindowGrowth = 1.1f;
+	static constexpr int maxGrowingWindows = 20;
+	static constexpr std::uint64_t checkpointInterval = 200;
+
+	// Everything the following steps depend on besides the parameters, so that a rolled back run
+	// resumes exactly where the checkpoint was taken and a recording can be cut off there.
+	struct Checkpoint
+	{
+		State state{};
+		std::uint64_t step = 0;
+		ControlCubeTrajectory controlCubeTrajectory = ControlCubeTrajectory::none;
+		float trajectoryT = 0;
+		Frame::Pose controlCubePose{};
+		Anchors anchors{};
+		bool controlCubeAnchorsReset = false;
+		std::vector<glm::quat> rotations{};
+		std::mt19937 randomEngine{};
+		std::uniform_real_distribution<float> uniformDistribution{0, 1};
+		std::normal_distribution<float> normalDistribution{0, 1};
+		float restTime = 0;
+		std::uint64_t stableDTStep = 0;
+		std::size_t recordedEventCount = 0;
+		std::size_t replayEvent = 0;
+		float energy = 0;
+	};
+
+	// RK4 is stable up to |lambda dt| of 2.78 along the negative real axis and 2.83 along the
+	// imaginary one, the smaller bounds the step for any mix of oscillation and damping. The
+	// estimate is refreshed every stableDTInterval steps to follow the geometric stiffness, and
+	// the automatic step only changes once it differs from it by automaticDTTolerance.
+	static constexpr float rk4StabilityRadius = 2.78f;
+	static constexpr float stableDTSafetyFactor = 0.9f;
+	static constexpr float maxAutomaticDT = 0.02f;
+	static constexpr float automaticDTTolerance = 0.01f;
+	static constexpr int stableDTIterations = 8;
+	static constexpr std::uint64_t stableDTInterval = 100;
+
+	float m_stableDT = 0;
+	bool m_stableDTOutdated = true;
+	std::uint64_t m_stableDTStep = 0;
+	// Power iteration starts from the stiffest mode found by the previous estimate.
+	std::array<glm::vec3, 64> m_stiffestMode{};
+
+	Diagnostics m_diagnostics{};
+	float m_windowEnergy = 0;
+	std::uint64_t m_windowStep = 0;
+	int m_growingWindows = 0;
+	// Checkpoints are taken after a step and kept once the next one found them stable.
+	std::array<Checkpoint, 2> m_checkpoints{};
+	Checkpoint m_pendingCheckpoint{};
+	bool m_checkpointPending = false;
+	std::uint64_t m_checkpointStep = 0;
+	bool m_rolledBack = false;
 
 	State m_state{};
+	std::uint64_t m_stateGeneration = 0;
+	// Steps taken or slept through since the simulation was created.
+	std::uint64_t m_step = 0;
+
+	// Positions and control cube pose before the last step. The rendered ones trail the physics by
+	// up to a step, blended from these by the time elapsed since the last step.
+	std::array<glm::vec3, 64> m_prevPoss{};
+	Frame::Pose m_prevControlCubePose{};
+	float m_renderAlpha = 1;
+	std::uint64_t m_renderGeneration = 0;
+
+	ControlCubeTrajectory m_controlCubeTrajectory = ControlCubeTrajectory::none;
+	std::optional<Trajectory> m_trajectory{};
+	float m_trajectoryT = 0;
+
+	std::optional<InputRecording> m_recording{};
+	bool m_isRecording = false;
+	std::uint64_t m_recordingStartStep = 0;
+	std::uint64_t m_recordedControlCubeGeneration = noGeneration;
+	bool m_isReplaying = false;
+	std::uint64_t m_replayStartStep = 0;
+	std::size_t m_replayEvent = 0;
+
+	static constexpr std::size_t springGrainSize = 128;
+	static constexpr std::size_t stepArenaCapacity = 1 << 16;
+	mutable Arena m_stepArena{stepArenaCapacity};
+
+	// Generations the rendered cubes and the models were last built from.
+	std::uint64_t m_elasticCubeGeneration = noGeneration;
+	std::uint64_t m_renderedControlCubeGeneration = noGeneration;
+	std::uint64_t m_massPointModelsGeneration = noGeneration;
+	std::uint64_t m_bezierCubeModelGeneration = noGeneration;
+	std::uint64_t m_internalSpringsModelGeneration = noGeneration;
+	std::uint64_t m_controlCubeModelGeneration = noGeneration;
+	std::uint64_t m_externalSpringsModelStateGeneration = noGeneration;
+	std::uint64_t m_externalSpringsModelControlCubeGeneration = noGeneration;
 
 	std::chrono::time_point<std::chrono::system_clock> m_t0{};
 	std::vector<float> m_t{};
+	// Step times are counted from the last time step change, so that it can change while running.
+	float m_dTChangeT = 0;
+	std::size_t m_dTChangeIteration = 0;
 
 	std::vector<Model*> m_massPointModels{};
 	Model& m_bezierCubeModel;
@@ -80,6 +337,16 @@ private:
 
 	ElasticCube m_elasticCube{cubeSize};
 	ControlCube m_controlCube{cubeSize};
+	ControlCube m_renderedControlCube{cubeSize};
+	LatticeTopology m_topology{ElasticCube::createVertices(cubeSize)};
+	CorotationalFEM m_corotationalFEM{m_topology};
+	XPBDSolver m_xpbdSolver{m_topology};
+
+	// The control cube drives the elastic cube corners through the first anchor range. After a
+	// restart its targets start at rest, so that a run does not depend on the pose before it.
+	Anchors m_anchors{};
+	std::size_t m_controlCubeAnchors{};
+	bool m_controlCubeAnchorsReset = false;
 
 	std::random_device m_randomDevice{};
 	std::mt19937 m_randomEngine{m_randomDevice()};
@@ -88,25 +355,70 @@ private:
 
 	float getSimulationTime() const;
 	void resetTime();
-	State getRHS(const State& state) const;
+	float getStepT(std::size_t iteration) const;
+	// Measures the diagnostics of the state if given.
+	State getRHS(const State& state, Diagnostics* diagnostics = nullptr) const;
+	void step(float t);
+	void stepRK4(float t);
+	void stepXPBD();
+	void updateSleep(const State& prevState, bool impact);
+	void wake();
+	// Checks the state the last step started from, which the diagnostics were measured of.
+	void checkStability();
+	float getStabilityEnergy() const;
+	float getStabilityEnergyFloor() const;
+	void saveCheckpoint(Checkpoint& checkpoint) const;
+	void loadCheckpoint(const Checkpoint& checkpoint);
+	void resetCheckpoints();
+	void rollBack();
+	void updateStableDT();
+	float estimateStableDT();
+
+	void selectTrajectory(ControlCubeTrajectory controlCubeTrajectory);
+	void updateTrajectory();
+	void restart(const State& state, std::uint32_t seed);
+	void record(InputRecording::Input input, const glm::vec3& value);
+	void recordSettings();
+	void recordParameters();
+	void recordControlCubePose();
+	void applyReplayEvents();
+	void applyEvent(const InputRecording::Event& event);
 
+	void updateRenderState(float renderAlpha);
 	void updateElasticCube();
+	void updateControlCubeAnchorParameters();
 
-	void updateModels() const;
+	void updateModels(const ModelVisibility& visibility,
+		std::pmr::memory_resource* frameResource);
 	void updateMassPointModels() const;
-	void updateBezierCubeModel() const;
-	void updateInternalSpringsModel() const;
+	void updateBezierCubeModel(std::pmr::memory_resource* frameResource) const;
+	void updateInternalSpringsModel(std::pmr::memory_resource* frameResource) const;
 	void updateControlCubeModel() const;
-	void updateExternalSpringsModel() const;
+	void updateExternalSpringsModel(std::pmr::memory_resource* frameResource) const;
 
-	std::vector<glm::vec3> getInternalSpringsForces(const State& state) const;
-	std::vector<glm::vec3> getExternalSpringsForces(const State& state) const;
-	std::vector<glm::vec3> getDampingForces(const State& state) const;
-	std::vector<glm::vec3> getGravityForces() const;
+	// Allocated from the step arena. The energies of the forces are measured if requested.
+	std::pmr::vector<glm::vec3> getInternalForces(const State& state,
+		float* energy = nullptr) const;
+	std::pmr::vector<glm::vec3> getInternalSpringsForces(const State& state,
+		float* energy = nullptr) const;
+	std::pmr::vector<glm::vec3> getAnchorForces(const State& state,
+		float* energy = nullptr) const;
+	// Also measures the kinetic and gravitational energy and the momentum, in the same pass.
+	std::pmr::vector<glm::vec3> getDampingForces(const State& state,
+		Diagnostics* diagnostics = nullptr) const;
+	std::pmr::vector<glm::vec3> getGravityForces() const;
+	// Product of the stiffness matrix of the internal forces and anchors and the direction,
+	// allocated from the step arena.
+	std::pmr::vector<glm::vec3> getStiffnessProduct(std::span<const glm::vec3> direction) const;
+	std::pmr::vector<glm::vec3> getInternalSpringsStiffnessProduct(const State& state,
+		std::span<const glm::vec3> direction) const;
 
-	void processCollisions();
-	bool processCollision(bool isWallPositive, float wallPos, float& particlePos,
+	// Returns whether any point hit a wall, recording which ones rest against one.
+	bool processCollisions();
+	Contact processCollision(bool isWallPositive, float wallPos, float& particlePos,
 		float& particleVelocity) const;
 
 	float particleMass() const;
+
+	static bool isOutdated(std::uint64_t& builtGeneration, std::uint64_t generation);
 };
@@ -3,22 +3,38 @@
 #include <glad/glad.h>
 #include <stb_image.h>
 
+#include <cstddef>
 #include <iostream>
+#include <optional>
 
-Texture::Texture(const std::string& path)
+Texture::Texture(const std::string& path) :
+	m_pendingImage{[path] () { return load(path); }}
 {
 	create();
-	load(path);
 }
 
-void Texture::use() const
+Texture::~Texture()
 {
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	glDeleteTextures(1, &m_id);
 }
 
-Texture::~Texture()
+bool Texture::isLoading() const
 {
-	glDeleteTextures(1, &m_id);
+	return m_pendingImage.isPending();
+}
+
+void Texture::update()
+{
+	std::optional<Image> image = m_pendingImage.poll();
+	if (image && !image->pixels.empty())
+	{
+		upload(*image);
+	}
+}
+
+void Texture::use() const
+{
+	glBindTexture(GL_TEXTURE_2D, m_id);
 }
 
 void Texture::create()
@@ -30,24 +46,37 @@ void Texture::create()
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	static constexpr unsigned char placeholderPixel[4] = {255, 255, 255, 255};
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+		placeholderPixel);
+	glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void Texture::upload(const Image& image) const
+{
+	glBindTexture(GL_TEXTURE_2D, m_id);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA,
+		GL_UNSIGNED_BYTE, image.pixels.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
 }
 
-void Texture::load(const std::string& path) const
+Texture::Image Texture::load(const std::string& path)
 {
-	int width{};
-	int height{};
+	Image image{};
 	int nrOfChannels{};
-	unsigned char* textureData = stbi_load(path.c_str(), &width, &height, &nrOfChannels,
-		STBI_rgb_alpha);
+	unsigned char* textureData = stbi_load(path.c_str(), &image.width, &image.height,
+		&nrOfChannels, STBI_rgb_alpha);
 	if (textureData)
 	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-			textureData);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		std::size_t size = static_cast<std::size_t>(image.width) *
+			static_cast<std::size_t>(image.height) * 4;
+		image.pixels.assign(textureData, textureData + size);
 	}
 	else
 	{
 		std::cerr << "Error loading texture: \n" << path << '\n';
 	}
 	stbi_image_free(textureData);
+	return image;
 }
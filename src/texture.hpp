@@ -1,6 +1,9 @@
 #pragma once
 
+#include "asyncLoad.hpp"
+
 #include <string>
+#include <vector>
 
 class Texture
 {
@@ -8,11 +11,23 @@ public:
 	Texture(const std::string& path);
 	~Texture();
 
+	bool isLoading() const;
+	void update();
 	void use() const;
 
 private:
+	struct Image
+	{
+		int width{};
+		int height{};
+		std::vector<unsigned char> pixels{};
+	};
+
 	unsigned int m_id;
+	AsyncLoad<Image> m_pendingImage{};
 
 	void create();
-	void load(const std::string& path) const;
+	void upload(const Image& image) const;
+
+	static Image load(const std::string& path);
 };
@@ -0,0 +1,120 @@
+#include "trajectory.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+Trajectory::Trajectory(const std::vector<Keyframe>& keyframes, bool loop) :
+	m_loop{loop}
+{
+	for (const Keyframe& keyframe : keyframes)
+	{
+		m_times.push_back(keyframe.t);
+		m_poss.push_back(keyframe.pos);
+		m_orientations.push_back(glm::quat{keyframe.anglesRad});
+	}
+}
+
+float Trajectory::getDuration() const
+{
+	return m_times.back() - m_times.front();
+}
+
+Frame::Pose Trajectory::evaluate(float t) const
+{
+	std::size_t count = m_times.size();
+	if (count == 1 || getDuration() <= 0)
+	{
+		return {m_poss.front(), m_orientations.front()};
+	}
+
+	if (m_loop)
+	{
+		float duration = getDuration();
+		t = m_times.front() + std::fmod(std::fmod(t - m_times.front(), duration) + duration,
+			duration);
+	}
+	t = std::clamp(t, m_times.front(), m_times.back());
+
+	std::size_t segment = static_cast<std::size_t>(
+		std::upper_bound(m_times.begin(), m_times.end(), t) - m_times.begin());
+	segment = std::clamp<std::size_t>(segment, 1, count - 1) - 1;
+	float segmentDuration = m_times[segment + 1] - m_times[segment];
+	float u = segmentDuration > 0 ? (t - m_times[segment]) / segmentDuration : 0;
+
+	// Catmull-Rom tangents for uneven keyframe spacing. Looping trajectories take the neighbors
+	// across the seam, open ones are one-sided at their ends.
+	auto tangent = [this, count] (std::size_t i)
+	{
+		std::size_t prev = i;
+		std::size_t next = i;
+		float prevTime = m_times[i];
+		float nextTime = m_times[i];
+		if (i > 0)
+		{
+			prev = i - 1;
+			prevTime = m_times[prev];
+		}
+		else if (m_loop)
+		{
+			prev = count - 2;
+			prevTime = m_times[prev] - getDuration();
+		}
+		if (i + 1 < count)
+		{
+			next = i + 1;
+			nextTime = m_times[next];
+		}
+		else if (m_loop)
+		{
+			next = 1;
+			nextTime = m_times[next] + getDuration();
+		}
+		return nextTime > prevTime ? (m_poss[next] - m_poss[prev]) / (nextTime - prevTime) :
+			glm::vec3{};
+	};
+
+	float u2 = u * u;
+	float u3 = u2 * u;
+	glm::vec3 pos = (2 * u3 - 3 * u2 + 1) * m_poss[segment] +
+		(u3 - 2 * u2 + u) * segmentDuration * tangent(segment) +
+		(-2 * u3 + 3 * u2) * m_poss[segment + 1] +
+		(u3 - u2) * segmentDuration * tangent(segment + 1);
+	glm::quat orientation = glm::slerp(m_orientations[segment], m_orientations[segment + 1], u);
+	return {pos, orientation};
+}
+
+Trajectory Trajectory::shake()
+{
+	static constexpr float amplitude = 1.5f;
+	static constexpr float period = 1.0f;
+	return Trajectory
+	{
+		{
+			{0, {0, 0, 0}, {}},
+			{period / 4, {amplitude, 0, 0}, {}},
+			{period / 2, {0, 0, 0}, {}},
+			{3 * period / 4, {-amplitude, 0, 0}, {}},
+			{period, {0, 0, 0}, {}}
+		},
+		true
+	};
+}
+
+Trajectory Trajectory::orbit()
+{
+	static constexpr float radius = 1.5f;
+	static constexpr float period = 8.0f;
+	static constexpr int keyframeCount = 8;
+
+	std::vector<Keyframe> keyframes{};
+	for (int i = 0; i <= keyframeCount; ++i)
+	{
+		float angle = 2 * glm::pi<float>() * i / keyframeCount;
+		keyframes.push_back({period * i / keyframeCount,
+			{radius * std::sin(angle), 0, radius * std::cos(angle)}, {0, angle, 0}});
+	}
+	return Trajectory{keyframes, true};
+}
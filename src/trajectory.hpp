@@ -0,0 +1,40 @@
+#pragma once
+
+#include "frame.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+// Keyframed path of a frame. Positions follow a Catmull-Rom spline through the keyframes and
+// orientations are interpolated spherically, so the motion is smooth and needs no tangents.
+class Trajectory
+{
+public:
+	struct Keyframe
+	{
+		float t{};
+		glm::vec3 pos{};
+		// Pitch, yaw and roll as used by Frame.
+		glm::vec3 anglesRad{};
+	};
+
+	// Keyframes have to be sorted by time. A looping trajectory wraps around after the last
+	// keyframe, which should then match the first one.
+	Trajectory(const std::vector<Keyframe>& keyframes, bool loop);
+
+	float getDuration() const;
+	Frame::Pose evaluate(float t) const;
+
+	// Quick back and forth motion along the long axis of the constraint box.
+	static Trajectory shake();
+	// Slow circle around the box center while turning to face along the path.
+	static Trajectory orbit();
+
+private:
+	std::vector<float> m_times{};
+	std::vector<glm::vec3> m_poss{};
+	std::vector<glm::quat> m_orientations{};
+	bool m_loop{};
+};
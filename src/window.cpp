@@ -1,5 +1,6 @@
 #include "window.hpp"
 
+#include "profiler/profiler.hpp"
 #include "shaderPrograms.hpp"
 
 #include <cmath>
@@ -28,10 +29,12 @@ Window::Window()
 
 	updateViewport();
 	ShaderPrograms::init();
+	Profiler::init();
 }
 
 Window::~Window()
 {
+	Profiler::shutdown();
 	glfwTerminate();
 }
 
@@ -0,0 +1,327 @@
+#include "xpbdSolver.hpp"
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+XPBDSolver::XPBDSolver(const LatticeTopology& topology) :
+	m_topology{topology}
+{
+	std::array<glm::vec3, 64> poss{};
+	std::copy(m_topology.getRestPoss().begin(), m_topology.getRestPoss().end(), poss.begin());
+
+	for (const LatticeTopology::Tetrahedron& tetrahedron : m_topology.getTetrahedra())
+	{
+		// Matches the energy of a uniformly scaled element to that of its springs, taking the edge
+		// length of the cell the element was cut from.
+		float restVolume = volume(poss, tetrahedron);
+		float edgeLength = std::cbrt(6 * std::abs(restVolume));
+		m_restVolumes.push_back(restVolume);
+		m_volumeComplianceScales.push_back(std::pow(edgeLength, 4.0f) / 4);
+	}
+}
+
+XPBDSolver::Energies XPBDSolver::step(State& state, float dT, float particleMass,
+	float stiffness, int iterations, std::size_t levelCount,
+	std::span<const glm::vec3> externalForces, const Anchors& anchors,
+	std::pmr::memory_resource* resource) const
+{
+	float inverseMass = 1 / particleMass;
+
+	std::array<glm::vec3, 64> prevPoss = state.poss;
+	for (std::size_t i = 0; i < state.poss.size(); ++i)
+	{
+		state.velocities[i] += dT * inverseMass * externalForces[i];
+		state.poss[i] += dT * state.velocities[i];
+	}
+
+	const std::vector<LatticeTopology::Spring>& springs = m_topology.getSprings();
+	const std::vector<LatticeTopology::Tetrahedron>& tetrahedra = m_topology.getTetrahedra();
+	std::pmr::vector<float> distanceLambdas(springs.size(), resource);
+	std::pmr::vector<float> volumeLambdas(tetrahedra.size(), resource);
+	std::pmr::vector<glm::vec3> anchorLambdas(anchors.size(), resource);
+	float compliance = stiffness > 0 ? 1 / (stiffness * dT * dT) : 0;
+
+	const std::vector<LatticeTopology::Level>& coarseLevels = m_topology.getCoarseLevels();
+	std::size_t coarseLevelCount = std::min(std::max<std::size_t>(levelCount, 1),
+		coarseLevels.size() + 1) - 1;
+	std::array<glm::vec3, 64> aggregateGradients{};
+
+	// Built once per step so that dispatching a batch does not allocate.
+	const std::vector<std::size_t>* batch = nullptr;
+	std::function<void(std::size_t, std::size_t)> projectDistances =
+		[this, &springs, &batch, &state, &distanceLambdas, inverseMass, compliance]
+		(std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				std::size_t spring = (*batch)[i];
+				projectDistance(springs[spring], m_topology.getSpringRestLengths()[spring],
+					state.poss, distanceLambdas[spring], inverseMass, compliance);
+			}
+		};
+	std::function<void(std::size_t, std::size_t)> projectVolumes =
+		[this, &tetrahedra, &batch, &state, &volumeLambdas, inverseMass, compliance]
+		(std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				std::size_t tetrahedron = (*batch)[i];
+				projectVolume(tetrahedra[tetrahedron], m_restVolumes[tetrahedron], state.poss,
+					volumeLambdas[tetrahedron], inverseMass,
+					m_volumeComplianceScales[tetrahedron] * compliance);
+			}
+		};
+
+	for (int iteration = 0; iteration < iterations; ++iteration)
+	{
+		if (stiffness > 0)
+		{
+			for (std::size_t level = 0; level < coarseLevelCount; ++level)
+			{
+				solveLevel(coarseLevels[level], state.poss, distanceLambdas, volumeLambdas,
+					inverseMass, compliance, aggregateGradients);
+			}
+			for (std::size_t level = coarseLevelCount; level-- > 1;)
+			{
+				solveLevel(coarseLevels[level - 1], state.poss, distanceLambdas, volumeLambdas,
+					inverseMass, compliance, aggregateGradients);
+			}
+
+			for (const std::vector<std::size_t>& distanceBatch : m_topology.getSpringBatches())
+			{
+				batch = &distanceBatch;
+				Parallel::forRange(distanceBatch.size(), batchGrainSize, projectDistances);
+			}
+
+			for (const std::vector<std::size_t>& volumeBatch : m_topology.getTetrahedronBatches())
+			{
+				batch = &volumeBatch;
+				Parallel::forRange(volumeBatch.size(), batchGrainSize, projectVolumes);
+			}
+		}
+
+		projectAnchors(anchors, state.poss, anchorLambdas, inverseMass, dT);
+	}
+
+	for (std::size_t i = 0; i < state.poss.size(); ++i)
+	{
+		state.velocities[i] = (state.poss[i] - prevPoss[i]) / dT;
+	}
+
+	Energies energies{};
+	for (float lambda : distanceLambdas)
+	{
+		energies.constraints += constraintEnergy(lambda * lambda, compliance, dT);
+	}
+	for (std::size_t i = 0; i < volumeLambdas.size(); ++i)
+	{
+		energies.constraints += constraintEnergy(volumeLambdas[i] * volumeLambdas[i],
+			m_volumeComplianceScales[i] * compliance, dT);
+	}
+	std::span<const float> anchorStiffnesses = anchors.getStiffnesses();
+	for (std::size_t i = 0; i < anchorLambdas.size(); ++i)
+	{
+		if (anchorStiffnesses[i] > 0)
+		{
+			energies.anchors += constraintEnergy(glm::dot(anchorLambdas[i], anchorLambdas[i]),
+				1 / (anchorStiffnesses[i] * dT * dT), dT);
+		}
+	}
+	return energies;
+}
+
+void XPBDSolver::solveLevel(const LatticeTopology::Level& level,
+	std::array<glm::vec3, 64>& poss, std::span<float> distanceLambdas,
+	std::span<float> volumeLambdas, float inverseMass, float compliance,
+	std::array<glm::vec3, 64>& aggregateGradients) const
+{
+	// Aggregates of a level share points, so they are projected one after another.
+	for (const LatticeTopology::Aggregate& aggregate : level.springAggregates)
+	{
+		projectDistanceAggregate(aggregate, poss, distanceLambdas, inverseMass, compliance,
+			aggregateGradients);
+	}
+	for (const LatticeTopology::Aggregate& aggregate : level.tetrahedronAggregates)
+	{
+		projectVolumeAggregate(aggregate, poss, volumeLambdas, inverseMass, compliance,
+			aggregateGradients);
+	}
+}
+
+void XPBDSolver::projectDistanceAggregate(const LatticeTopology::Aggregate& aggregate,
+	std::array<glm::vec3, 64>& poss, std::span<float> lambdas, float inverseMass,
+	float compliance, std::array<glm::vec3, 64>& aggregateGradients) const
+{
+	const std::vector<LatticeTopology::Spring>& springs = m_topology.getSprings();
+	const std::vector<float>& restLengths = m_topology.getSpringRestLengths();
+	float residual = 0;
+	for (std::size_t spring : aggregate.constraints)
+	{
+		glm::vec3 delta = poss[springs[spring][1]] - poss[springs[spring][0]];
+		float length = glm::length(delta);
+		if (length == 0)
+		{
+			continue;
+		}
+		glm::vec3 direction = delta / length;
+
+		residual -= length - restLengths[spring] + compliance * lambdas[spring];
+		aggregateGradients[springs[spring][0]] -= direction;
+		aggregateGradients[springs[spring][1]] += direction;
+	}
+
+	applyAggregate(aggregate, residual, aggregate.constraints.size() * compliance, poss, lambdas,
+		inverseMass, aggregateGradients);
+}
+
+void XPBDSolver::projectVolumeAggregate(const LatticeTopology::Aggregate& aggregate,
+	std::array<glm::vec3, 64>& poss, std::span<float> lambdas, float inverseMass,
+	float compliance, std::array<glm::vec3, 64>& aggregateGradients) const
+{
+	const std::vector<LatticeTopology::Tetrahedron>& tetrahedra = m_topology.getTetrahedra();
+	float residual = 0;
+	float aggregateCompliance = 0;
+	for (std::size_t tetrahedron : aggregate.constraints)
+	{
+		std::array<glm::vec3, 4> gradients{};
+		float value = volumeGradients(tetrahedra[tetrahedron], poss, gradients) -
+			m_restVolumes[tetrahedron];
+		float tetrahedronCompliance = m_volumeComplianceScales[tetrahedron] * compliance;
+
+		residual -= value + tetrahedronCompliance * lambdas[tetrahedron];
+		aggregateCompliance += tetrahedronCompliance;
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			aggregateGradients[tetrahedra[tetrahedron][i]] += gradients[i];
+		}
+	}
+
+	applyAggregate(aggregate, residual, aggregateCompliance, poss, lambdas, inverseMass,
+		aggregateGradients);
+}
+
+void XPBDSolver::applyAggregate(const LatticeTopology::Aggregate& aggregate, float residual,
+	float compliance, std::array<glm::vec3, 64>& poss, std::span<float> lambdas,
+	float inverseMass, std::array<glm::vec3, 64>& aggregateGradients)
+{
+	// Changing every multiplier by the same amount is the Gauss-Seidel update of the constraint
+	// summed over the aggregate, whose gradient is the sum of theirs.
+	float gradientNorm = 0;
+	for (std::size_t point : aggregate.points)
+	{
+		gradientNorm += glm::dot(aggregateGradients[point], aggregateGradients[point]);
+	}
+	float denominator = inverseMass * gradientNorm + compliance;
+	float deltaLambda = denominator > 0 ? residual / denominator : 0;
+
+	for (std::size_t constraint : aggregate.constraints)
+	{
+		lambdas[constraint] += deltaLambda;
+	}
+	for (std::size_t point : aggregate.points)
+	{
+		poss[point] += inverseMass * deltaLambda * aggregateGradients[point];
+		aggregateGradients[point] = {};
+	}
+}
+
+float XPBDSolver::volume(const std::array<glm::vec3, 64>& poss,
+	const LatticeTopology::Tetrahedron& tetrahedron)
+{
+	return glm::dot(poss[tetrahedron[1]] - poss[tetrahedron[0]],
+		glm::cross(poss[tetrahedron[2]] - poss[tetrahedron[0]],
+		poss[tetrahedron[3]] - poss[tetrahedron[0]])) / 6;
+}
+
+float XPBDSolver::volumeGradients(const LatticeTopology::Tetrahedron& tetrahedron,
+	const std::array<glm::vec3, 64>& poss, std::array<glm::vec3, 4>& gradients)
+{
+	glm::vec3 edge1 = poss[tetrahedron[1]] - poss[tetrahedron[0]];
+	glm::vec3 edge2 = poss[tetrahedron[2]] - poss[tetrahedron[0]];
+	glm::vec3 edge3 = poss[tetrahedron[3]] - poss[tetrahedron[0]];
+
+	gradients[1] = glm::cross(edge2, edge3) / 6.0f;
+	gradients[2] = glm::cross(edge3, edge1) / 6.0f;
+	gradients[3] = glm::cross(edge1, edge2) / 6.0f;
+	gradients[0] = -(gradients[1] + gradients[2] + gradients[3]);
+	return glm::dot(edge1, gradients[1]);
+}
+
+void XPBDSolver::projectDistance(const LatticeTopology::Spring& spring, float restLength,
+	std::array<glm::vec3, 64>& poss, float& lambda, float inverseMass, float compliance)
+{
+	glm::vec3 delta = poss[spring[1]] - poss[spring[0]];
+	float length = glm::length(delta);
+	if (length == 0)
+	{
+		return;
+	}
+	glm::vec3 direction = delta / length;
+
+	float value = length - restLength;
+	float deltaLambda = (-value - compliance * lambda) / (2 * inverseMass + compliance);
+	lambda += deltaLambda;
+
+	poss[spring[0]] -= inverseMass * deltaLambda * direction;
+	poss[spring[1]] += inverseMass * deltaLambda * direction;
+}
+
+void XPBDSolver::projectVolume(const LatticeTopology::Tetrahedron& tetrahedron, float restVolume,
+	std::array<glm::vec3, 64>& poss, float& lambda, float inverseMass, float compliance)
+{
+	std::array<glm::vec3, 4> gradients{};
+	float currentVolume = volumeGradients(tetrahedron, poss, gradients);
+
+	float gradientNorm = 0;
+	for (const glm::vec3& gradient : gradients)
+	{
+		gradientNorm += glm::dot(gradient, gradient);
+	}
+	float denominator = inverseMass * gradientNorm + compliance;
+	if (denominator == 0)
+	{
+		return;
+	}
+
+	float value = currentVolume - restVolume;
+	float deltaLambda = (-value - compliance * lambda) / denominator;
+	lambda += deltaLambda;
+
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		poss[tetrahedron[i]] += inverseMass * deltaLambda * gradients[i];
+	}
+}
+
+void XPBDSolver::projectAnchors(const Anchors& anchors, std::array<glm::vec3, 64>& poss,
+	std::span<glm::vec3> lambdas, float inverseMass, float dT)
+{
+	// Zero-length springs to kinematic targets, solved as one constraint per axis.
+	std::span<const std::size_t> points = anchors.getPoints();
+	std::span<const glm::vec3> targets = anchors.getTargets();
+	std::span<const float> stiffnesses = anchors.getStiffnesses();
+	for (std::size_t i = 0; i < points.size(); ++i)
+	{
+		if (stiffnesses[i] <= 0)
+		{
+			continue;
+		}
+		float compliance = 1 / (stiffnesses[i] * dT * dT);
+
+		glm::vec3 value = poss[points[i]] - targets[i];
+		glm::vec3 deltaLambda = (-value - compliance * lambdas[i]) / (inverseMass + compliance);
+		lambdas[i] += deltaLambda;
+
+		poss[points[i]] += inverseMass * deltaLambda;
+	}
+}
+
+float XPBDSolver::constraintEnergy(float lambdaSquared, float compliance, float dT)
+{
+	// A converged constraint is displaced by its compliance times its multiplier, so its energy
+	// follows from the multiplier without evaluating the constraint again.
+	return 0.5f * compliance * lambdaSquared / (dT * dT);
+}
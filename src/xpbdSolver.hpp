@@ -0,0 +1,73 @@
+#pragma once
+
+#include "anchors.hpp"
+#include "latticeTopology.hpp"
+#include "state.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+// Extended position-based dynamics (Macklin et al. 2016). Distance constraints follow the springs
+// and volume constraints follow the tetrahedra of the lattice. Constraints are graph-colored, and
+// every color is projected in parallel as one Gauss-Seidel batch. With more than one level, every
+// iteration is a V-cycle on the multipliers: the coarser levels move aggregates of the lattice
+// constraints from the finest level down and back up, correcting the smooth part of the error that
+// Gauss-Seidel reduces slowly, and the lattice constraints are smoothed again afterwards. The
+// aggregates update the multipliers of the lattice constraints themselves, so the solution the
+// iterations converge to does not depend on the level count.
+class XPBDSolver
+{
+public:
+	// Energy held by the constraints at the end of a step.
+	struct Energies
+	{
+		float constraints = 0;
+		float anchors = 0;
+	};
+
+	XPBDSolver(const LatticeTopology& topology);
+
+	Energies step(State& state, float dT, float particleMass, float stiffness, int iterations,
+		std::size_t levelCount, std::span<const glm::vec3> externalForces,
+		const Anchors& anchors,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+private:
+	static constexpr std::size_t batchGrainSize = 64;
+
+	const LatticeTopology& m_topology;
+	std::vector<float> m_restVolumes{};
+	std::vector<float> m_volumeComplianceScales{};
+
+	// Gradients of the aggregates are summed in aggregateGradients, which is left zeroed.
+	void solveLevel(const LatticeTopology::Level& level, std::array<glm::vec3, 64>& poss,
+		std::span<float> distanceLambdas, std::span<float> volumeLambdas, float inverseMass,
+		float compliance, std::array<glm::vec3, 64>& aggregateGradients) const;
+	void projectDistanceAggregate(const LatticeTopology::Aggregate& aggregate,
+		std::array<glm::vec3, 64>& poss, std::span<float> lambdas, float inverseMass,
+		float compliance, std::array<glm::vec3, 64>& aggregateGradients) const;
+	void projectVolumeAggregate(const LatticeTopology::Aggregate& aggregate,
+		std::array<glm::vec3, 64>& poss, std::span<float> lambdas, float inverseMass,
+		float compliance, std::array<glm::vec3, 64>& aggregateGradients) const;
+	static void applyAggregate(const LatticeTopology::Aggregate& aggregate, float residual,
+		float compliance, std::array<glm::vec3, 64>& poss, std::span<float> lambdas,
+		float inverseMass, std::array<glm::vec3, 64>& aggregateGradients);
+
+	static float volume(const std::array<glm::vec3, 64>& poss,
+		const LatticeTopology::Tetrahedron& tetrahedron);
+	// Returns the volume, computed from the gradients.
+	static float volumeGradients(const LatticeTopology::Tetrahedron& tetrahedron,
+		const std::array<glm::vec3, 64>& poss, std::array<glm::vec3, 4>& gradients);
+	static void projectDistance(const LatticeTopology::Spring& spring, float restLength,
+		std::array<glm::vec3, 64>& poss, float& lambda, float inverseMass, float compliance);
+	static void projectVolume(const LatticeTopology::Tetrahedron& tetrahedron, float restVolume,
+		std::array<glm::vec3, 64>& poss, float& lambda, float inverseMass, float compliance);
+	static void projectAnchors(const Anchors& anchors, std::array<glm::vec3, 64>& poss,
+		std::span<glm::vec3> lambdas, float inverseMass, float dT);
+	static float constraintEnergy(float lambdaSquared, float compliance, float dT);
+};